@@ -0,0 +1,149 @@
+// Executables must have the following defined if the library contains
+// doctest definitions. For builds with this disabled, e.g. code shipped to
+// users, this can be left out.
+#ifdef ENABLE_DOCTEST_IN_LIBRARY
+#define DOCTEST_CONFIG_IMPLEMENT
+#include "doctest/doctest.h"
+#endif
+
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "generator.h"
+#include "item.h"
+#include "job.h"
+#include "multi_machine.h"
+#include "problem.h"
+
+// Benchmark of Schrage dispatching on parallel machines: for growing numbers
+// of items and machines prints the time of one dispatch, the total time found
+// and its distance from the lower bound. Occurrence and idle times are spread
+// over the expected load of one machine, so all machines stay busy.
+//
+// Then times the single-machine algorithms of Problem on random instances of
+// a fixed size, so that builds with different options (see run_bench.py) can
+// be compared on both parts, and finally the same algorithms with the items
+// stored as Item<int>, Item<short> and SoaJob for growing instances.
+
+// Runs an algorithm repeatedly for at least 200 ms and returns the time of one run in ms.
+static double measure(const std::function<void()> &algorithm) {
+  algorithm(); // warm-up
+  size_t repeats = 0;
+  auto start = std::chrono::steady_clock::now();
+  double ms = 0;
+  do {
+    algorithm();
+    repeats++;
+    ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  } while (ms < 200);
+  return ms / double(repeats);
+}
+
+// Times an algorithm of Problem<Job> on the given items converted to Job.
+template<class Job>
+static double measureLayout(const std::vector<Item<int>> &items, void (Problem<Job>::*algorithm)()) {
+  std::size_t rows = SoaJobStore::local().size();
+  std::vector<Job> jobs;
+  jobs.reserve(items.size());
+  for (const Item<int> &item: items) {
+    jobs.emplace_back(item.getId(), item.getOccurTime(), item.getWorkTime(), item.getIdleTime());
+  }
+  Problem<Job> problem;
+  problem.setVerbose(false);
+  problem.setItems(jobs);
+  double ms = measure([&]() { (problem.*algorithm)(); });
+  jobs.clear();
+  problem.setItems(jobs);
+  SoaJobStore::local().truncate(rows);
+  return ms;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc > 4) {
+    std::cout << "Użycie: " << argv[0] << " [maks. liczba zadań] [maks. liczba maszyn] [ziarno]" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  size_t max_items = (argc > 1) ? std::stoul(argv[1]) : 1000000;
+  int max_machines = (argc > 2) ? std::stoi(argv[2]) : 256;
+  uint32_t seed = (argc > 3) ? uint32_t(std::stoul(argv[3])) : 1;
+  const int max_work_time = 30;
+
+  std::cout << std::setw(9) << "zadania" << std::setw(8) << "maszyny" << std::setw(14) << "czas [ms]"
+            << std::setw(12) << "ns/zadanie" << std::setw(12) << "Cmax" << std::setw(12) << "dolna gr."
+            << std::setw(10) << "luka [%]" << '\n';
+
+  for (size_t items_count = 1000; items_count <= max_items; items_count *= 10) {
+    for (int machine_count = 1; machine_count <= max_machines; machine_count *= 2) {
+      int spread = int(items_count * max_work_time / 2 / size_t(machine_count));
+      std::vector<Item<int>> items =
+          generateInstance<Item<int>>(items_count, seed, max_work_time, spread, spread);
+
+      MachineScheduler<Item<int>> scheduler(machine_count);
+      MachineSchedule schedule;
+      int total_time = scheduler.dispatch(items, schedule); // warm-up, sizes the buffers
+
+      // Repeat small instances so that every measurement takes a while.
+      size_t repeats = std::max<size_t>(1, 1000000 / items_count);
+      auto start = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < repeats; i++) {
+        total_time = scheduler.dispatch(items, schedule);
+      }
+      double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() /
+                  double(repeats);
+
+      int lower_bound = MachineScheduler<Item<int>>::lowerBound(items, machine_count);
+      std::cout << std::setw(9) << items_count << std::setw(8) << machine_count << std::setw(14) << std::fixed
+                << std::setprecision(3) << ms << std::setw(12) << std::setprecision(1)
+                << ms * 1e6 / double(items_count) << std::setw(12) << total_time << std::setw(12) << lower_bound
+                << std::setw(10) << std::setprecision(2) << 100.0 * (total_time - lower_bound) / lower_bound
+                << '\n';
+    }
+  }
+
+  struct SolverCase {
+    const char *name;
+    size_t items_count;
+    void (Problem<Item<int>>::*algorithm)();
+  };
+  const SolverCase solver_cases[] = {
+      {"schrage", 10000, &Problem<Item<int>>::schrageAlgorithmV2},
+      {"schrage-pmtn", 10000, &Problem<Item<int>>::schrageAlgorithmWithExpropriation},
+      {"bisora", 10000, &Problem<Item<int>>::bisoraAlgorithm},
+      {"dp", 12, &Problem<Item<int>>::subsetDynamicProgramming},
+      {"dp", 18, &Problem<Item<int>>::subsetDynamicProgramming},
+      {"reduced", 10000, &Problem<Item<int>>::reducedSolve},
+  };
+
+  std::cout << '\n' << std::setw(14) << "algorytm" << std::setw(9) << "zadania" << std::setw(14) << "czas [ms]"
+            << std::setw(12) << "Cmax" << '\n';
+  Problem<Item<int>> problem;
+  problem.setVerbose(false);
+  for (const SolverCase &solver_case: solver_cases) {
+    problem.setItems(generateInstance<Item<int>>(solver_case.items_count, seed));
+    double ms = measure([&]() { (problem.*solver_case.algorithm)(); });
+    std::cout << std::setw(14) << solver_case.name << std::setw(9) << solver_case.items_count << std::setw(14)
+              << std::fixed << std::setprecision(3) << ms << std::setw(12) << problem.getResultTime() << '\n';
+  }
+
+  std::cout << '\n' << std::setw(14) << "algorytm" << std::setw(9) << "zadania" << std::setw(14) << "Item<int>"
+            << std::setw(14) << "Item<short>" << std::setw(14) << "SoaJob" << "   [ms]\n";
+  for (size_t items_count = 100; items_count <= 100000 && items_count <= max_items; items_count *= 10) {
+    // 16-bit times have to hold the occurrence and idle times.
+    std::vector<Item<int>> items = generateInstance<Item<int>>(items_count, seed, 30, 30000, 30000);
+    auto layouts = [&](const char *name, auto algorithm) {
+      std::cout << std::setw(14) << name << std::setw(9) << items_count << std::setw(14) << std::fixed
+                << std::setprecision(3) << measureLayout<Item<int>>(items, algorithm(Item<int>()))
+                << std::setw(14) << measureLayout<Item<short>>(items, algorithm(Item<short>()))
+                << std::setw(14) << measureLayout<SoaJob>(items, algorithm(SoaJob())) << '\n';
+    };
+    layouts("schrage", [](auto job) { return &Problem<decltype(job)>::schrageAlgorithmV2; });
+    layouts("schrage-pmtn", [](auto job) { return &Problem<decltype(job)>::schrageAlgorithmWithExpropriation; });
+    layouts("bisora", [](auto job) { return &Problem<decltype(job)>::bisoraAlgorithm; });
+    layouts("reduced", [](auto job) { return &Problem<decltype(job)>::reducedSolve; });
+  }
+  return 0;
+}
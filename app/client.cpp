@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "socket_lines.h"
+
+// Load generator for the solve server: sends the same instance many times,
+// keeping up to <pipeline> requests in flight, and reports the throughput and
+// the latency distribution of the answers.
+
+using Clock = std::chrono::steady_clock;
+
+int main(int argc, char *argv[]) {
+  if (argc < 3 || argc > 7) {
+    std::cout << "Użycie: " << argv[0]
+              << " <ścieżka gniazda> <plik z danymi> [liczba zapytań] [zapytania w locie] [algorytm] [termin ms]"
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::string socket_path = argv[1];
+  size_t request_count = (argc > 3) ? std::stoul(argv[3]) : 1000;
+  size_t pipeline = (argc > 4) ? std::max<size_t>(1, std::stoul(argv[4])) : 16;
+  std::string algorithm = (argc > 5) ? argv[5] : "schrage";
+  std::string deadline_ms = (argc > 6) ? argv[6] : "0";
+
+  std::ifstream input_file(argv[2]);
+  if (!input_file.is_open()) {
+    std::cerr << "Nie udało się otworzyć pliku: " << argv[2] << "!\n";
+    exit(EXIT_FAILURE);
+  }
+  std::stringstream instance;
+  instance << input_file.rdbuf();
+  std::string body = instance.str();
+  if (!body.empty() && body.back() != '\n') {
+    body += '\n';
+  }
+
+  sockaddr_un address;
+  int socket_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (!makeSocketAddress(socket_path, address) || socket_fd < 0 ||
+      connect(socket_fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0) {
+    std::cerr << "Nie udało się połączyć z serwerem: " << socket_path << "!\n";
+    exit(EXIT_FAILURE);
+  }
+
+  std::vector<Clock::time_point> sent_at(request_count);
+  std::mutex mutex;
+  std::condition_variable slot_free;
+  size_t in_flight = 0;
+  bool finished = false; // the reader stopped: no more slots will be freed
+
+  Clock::time_point start = Clock::now();
+  std::thread sender([&]() {
+    for (size_t id = 0; id < request_count; id++) {
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        slot_free.wait(lock, [&]() { return finished || in_flight < pipeline; });
+        if (finished) {
+          break;
+        }
+        in_flight++;
+        sent_at[id] = Clock::now();
+      }
+      std::string request = "SOLVE " + std::to_string(id) + " " + algorithm + " " + deadline_ms + "\n" + body;
+      if (!sendAll(socket_fd, request)) {
+        break;
+      }
+    }
+  });
+
+  SocketLineReader reader(socket_fd);
+  std::vector<double> latency_us;
+  latency_us.reserve(request_count);
+  size_t partial = 0, expired = 0, failed = 0;
+  std::string line;
+
+  while (latency_us.size() + expired + failed < request_count && reader.readLine(line)) {
+    std::istringstream words(line);
+    std::string status;
+    size_t id = 0;
+    words >> status >> id;
+    Clock::time_point received_at = Clock::now();
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      in_flight -= (in_flight > 0) ? 1 : 0;
+    }
+    slot_free.notify_one();
+
+    if ((status == "RESULT" || status == "PARTIAL") && id < request_count) {
+      partial += (status == "PARTIAL") ? 1 : 0;
+      latency_us.push_back(std::chrono::duration<double, std::micro>(received_at - sent_at[id]).count());
+    } else if (status == "EXPIRED") {
+      expired++;
+    } else {
+      failed++;
+      std::cerr << line << "\n";
+    }
+  }
+  double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    finished = true;
+  }
+  slot_free.notify_all();
+  shutdown(socket_fd, SHUT_RDWR);
+  sender.join();
+  close(socket_fd);
+
+  std::sort(latency_us.begin(), latency_us.end());
+  auto percentile = [&](double fraction) {
+    if (latency_us.empty()) {
+      return 0.0;
+    }
+    return latency_us[std::min(latency_us.size() - 1, size_t(fraction * double(latency_us.size())))];
+  };
+
+  std::cout << "Rozwiązane: " << latency_us.size() << " (przerwane: " << partial << "), po terminie: " << expired
+            << ", błędy: " << failed << "\n";
+  size_t lost = request_count - latency_us.size() - expired - failed;
+  if (lost > 0) {
+    std::cerr << "Serwer zamknął połączenie, bez odpowiedzi: " << lost << "\n";
+  }
+  std::cout << "Przepustowość: " << double(latency_us.size() + expired + failed) / seconds << " zapytań/s\n";
+  std::cout << "Opóźnienie [us] p50: " << percentile(0.50) << "  p90: " << percentile(0.90)
+            << "  p99: " << percentile(0.99) << "  p99.9: " << percentile(0.999)
+            << "  max: " << (latency_us.empty() ? 0.0 : latency_us.back()) << std::endl;
+  return (failed == 0 && lost == 0) ? 0 : 1;
+}
@@ -0,0 +1,305 @@
+// Executables must have the following defined if the library contains
+// doctest definitions. For builds with this disabled, e.g. code shipped to
+// users, this can be left out.
+#ifdef ENABLE_DOCTEST_IN_LIBRARY
+#define DOCTEST_CONFIG_IMPLEMENT
+#include "doctest/doctest.h"
+#endif
+
+#include <atomic>
+#include <condition_variable>
+#include <csignal>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+#include <pthread.h>
+#include <sys/stat.h>
+
+#include "socket_lines.h"
+#include "solve_service.h"
+
+// Long running solver: listens on a Unix domain socket, reads requests
+// ("SOLVE <id> <algorithm> <deadline ms>" followed by an instance in the
+// data file format) and answers each with one line as soon as it is solved.
+// Requests on one connection may be sent without waiting for answers; a
+// connection is not read while the queue of the service is full.
+// SIGINT or SIGTERM stop the server: it stops accepting and reading, answers
+// the requests it already has and removes the socket.
+
+namespace {
+
+/// Default number of connections served at the same time.
+constexpr std::size_t DEFAULT_CONNECTION_LIMIT = 64;
+
+/// Longest line read from a client; requests and items are much shorter.
+constexpr std::size_t REQUEST_LINE_LIMIT = 4096;
+
+/**
+ * @brief A client connection, kept alive until its last answer is sent.
+ */
+struct Connection {
+    int socket_fd; ///< The connected socket.
+    std::mutex write_mutex; ///< Keeps answers from interleaving.
+
+    explicit Connection(int socket_fd_s) : socket_fd(socket_fd_s) {}
+
+    ~Connection() { close(socket_fd); }
+
+    void answer(const SolveResponse &response) {
+        std::string line = formatResponse(response) + "\n";
+        std::lock_guard<std::mutex> lock(write_mutex);
+        sendAll(socket_fd, line);
+    }
+};
+
+/**
+ * @brief The connections still reading requests: bounds their number and stops them.
+ */
+class ConnectionRegistry {
+private:
+    std::mutex mutex; ///< Guards the sockets and the stopping flag.
+    std::condition_variable changed; ///< Signalled when a connection ends or the server stops.
+    std::set<int> readers; ///< Sockets of the connections still reading requests.
+    std::size_t limit; ///< Largest number of such connections.
+    bool stopping; ///< Whether the server is stopping.
+
+public:
+    explicit ConnectionRegistry(std::size_t limit_s) : limit(limit_s), stopping(false) {}
+
+    /**
+     * @brief Wait until another connection may be accepted.
+     * @return false If the server is stopping.
+     */
+    bool waitForSlot() {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this]() { return stopping || readers.size() < limit; });
+        return !stopping;
+    }
+
+    /**
+     * @brief Register an accepted connection.
+     * @param socket_fd Its socket.
+     * @return false If the server is stopping (the connection must not be served).
+     */
+    bool add(int socket_fd) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping) {
+            return false;
+        }
+        readers.insert(socket_fd);
+        return true;
+    }
+
+    /**
+     * @brief Unregister a connection whose reader ends; the last use of the registry by that reader.
+     * @param socket_fd Its socket.
+     */
+    void remove(int socket_fd) {
+        std::lock_guard<std::mutex> lock(mutex);
+        readers.erase(socket_fd);
+        changed.notify_all();
+    }
+
+    /**
+     * @brief Stop accepting and end the reading of every connection (answers are still sent).
+     */
+    void stop() {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        for (int socket_fd: readers) {
+            shutdown(socket_fd, SHUT_RD);
+        }
+        changed.notify_all();
+    }
+
+    /**
+     * @brief Wait until every reader has ended.
+     */
+    void waitUntilEmpty() {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this]() { return readers.empty(); });
+    }
+};
+
+void serveConnection(std::shared_ptr<Connection> connection, SolveService &service, ConnectionRegistry &registry) {
+    SocketLineReader reader(connection->socket_fd, REQUEST_LINE_LIMIT);
+    std::string line;
+
+    while (reader.readLine(line)) {
+        if (line.empty()) {
+            continue;
+        }
+
+        // A broken header leaves no way to find the next request, so the
+        // connection is closed after the answer.
+        SolveRequest request;
+        SolveResponse failure;
+        if (!parseRequestHeader(line, request, failure.error)) {
+            connection->answer(failure);
+            break;
+        }
+
+        std::string count_line;
+        if (!reader.readLine(count_line)) {
+            break;
+        }
+        int count = 0;
+        try {
+            count = std::stoi(count_line);
+        } catch (const std::exception &) {
+            count = -1;
+        }
+        if (count < 0) {
+            failure.id = request.id;
+            failure.error = "Dane zostały źle podzielone!";
+            connection->answer(failure);
+            continue;
+        }
+        // The items of a refused instance are not read, so the connection
+        // cannot go on after it.
+        if (std::size_t(count) > SERVICE_ITEM_LIMIT) {
+            failure.id = request.id;
+            failure.error = "Zbyt wiele zadań (limit: " + std::to_string(SERVICE_ITEM_LIMIT) + ")!";
+            connection->answer(failure);
+            break;
+        }
+
+        request.instance = count_line + "\n";
+        bool complete = true;
+        for (int i = 0; i < count && complete; i++) {
+            complete = reader.readLine(line);
+            request.instance += line + "\n";
+        }
+        if (!complete) {
+            break;
+        }
+
+        // Waits while the queue of the service is full, which stops the reading.
+        service.submit(std::move(request),
+                       [connection](const SolveResponse &response) { connection->answer(response); });
+    }
+    shutdown(connection->socket_fd, SHUT_RD);
+    registry.remove(connection->socket_fd);
+}
+
+/**
+ * @brief Remove a socket left behind by a server that has stopped.
+ * @param socket_path The path of the socket.
+ * @param address Its address.
+ * @return false If the path is not a socket or another server still answers on it.
+ */
+bool removeStaleSocket(const std::string &socket_path, const sockaddr_un &address) {
+    struct stat status;
+    if (lstat(socket_path.c_str(), &status) < 0) {
+        return errno == ENOENT;
+    }
+    if (!S_ISSOCK(status.st_mode)) {
+        std::cerr << "Ścieżka istnieje i nie jest gniazdem: " << socket_path << "!\n";
+        return false;
+    }
+    int probe_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    bool answered = probe_fd >= 0 && connect(probe_fd, reinterpret_cast<const sockaddr *>(&address),
+                                             sizeof(address)) == 0;
+    if (probe_fd >= 0) {
+        close(probe_fd);
+    }
+    if (answered) {
+        std::cerr << "Na gnieździe " << socket_path << " działa już inny serwer!\n";
+        return false;
+    }
+    return unlink(socket_path.c_str()) == 0;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  if (argc < 2 || argc > 4) {
+    std::cout << "Użycie: " << argv[0] << " <ścieżka gniazda> [liczba wątków] [limit połączeń]" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::string socket_path = argv[1];
+  unsigned worker_count = (argc >= 3) ? unsigned(std::stoul(argv[2])) : 0;
+  std::size_t connection_limit = (argc == 4) ? std::stoul(argv[3]) : DEFAULT_CONNECTION_LIMIT;
+  if (connection_limit == 0) {
+    std::cerr << "Limit połączeń musi być dodatni!\n";
+    exit(EXIT_FAILURE);
+  }
+
+  sockaddr_un address;
+  if (!makeSocketAddress(socket_path, address)) {
+    std::cerr << "Zbyt długa ścieżka gniazda: " << socket_path << "!\n";
+    exit(EXIT_FAILURE);
+  }
+
+  if (!removeStaleSocket(socket_path, address)) {
+    exit(EXIT_FAILURE);
+  }
+  int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listen_fd < 0 || bind(listen_fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 ||
+      listen(listen_fd, SOMAXCONN) < 0) {
+    std::cerr << "Nie udało się otworzyć gniazda: " << socket_path << "!\n";
+    exit(EXIT_FAILURE);
+  }
+
+  // Every thread blocks the stopping signals; one thread waits for them,
+  // stops the registry and wakes accept() by connecting to the socket.
+  sigset_t stop_signals;
+  sigemptyset(&stop_signals);
+  sigaddset(&stop_signals, SIGINT);
+  sigaddset(&stop_signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &stop_signals, nullptr);
+
+  ConnectionRegistry registry(connection_limit);
+  std::atomic<bool> signalled(false);
+  std::thread signal_waiter([&]() {
+    int received = 0;
+    sigwait(&stop_signals, &received);
+    signalled = true;
+    registry.stop();
+    int wake_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (wake_fd >= 0) {
+      connect(wake_fd, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+      close(wake_fd);
+    }
+  });
+
+  {
+    SolveService service(worker_count);
+    std::cout << "Serwer nasłuchuje na " << socket_path << std::endl;
+
+    while (registry.waitForSlot()) {
+      int client_fd = accept(listen_fd, nullptr, nullptr);
+      if (client_fd < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        std::cerr << "Błąd przyjmowania połączenia!\n";
+        break;
+      }
+      if (!registry.add(client_fd)) {
+        close(client_fd);
+        break;
+      }
+      std::thread(serveConnection, std::make_shared<Connection>(client_fd), std::ref(service), std::ref(registry))
+          .detach();
+    }
+
+    if (!signalled) {
+      pthread_kill(signal_waiter.native_handle(), SIGTERM); // accepting failed: end the signal thread
+    }
+    signal_waiter.join();
+    registry.stop();
+    close(listen_fd);
+    registry.waitUntilEmpty();
+    // The service answers the queued requests before it stops.
+  }
+
+  unlink(socket_path.c_str());
+  std::cout << "Serwer zatrzymany" << std::endl;
+  return 0;
+}
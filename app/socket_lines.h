@@ -0,0 +1,99 @@
+#pragma once
+
+// Line based I/O over a POSIX socket, shared by the solve server and client.
+
+#include <cerrno>
+#include <cstdint>
+#include <string>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/**
+ * @brief Reads a socket line by line through one large buffer.
+ */
+class SocketLineReader {
+private:
+    int socket_fd; /**< The socket to read from. */
+    std::string buffer; /**< Received data not returned yet. */
+    size_t position; /**< Start of the unread part of the buffer. */
+    size_t max_line; /**< Longest line accepted. */
+
+public:
+    /**
+     * @brief Constructor taking the socket to read from.
+     * @param socket_fd_s The connected socket.
+     * @param max_line_s Longest line accepted (a longer one ends the reading).
+     */
+    explicit SocketLineReader(int socket_fd_s, size_t max_line_s = SIZE_MAX)
+        : socket_fd(socket_fd_s), position(0), max_line(max_line_s) {}
+
+    /**
+     * @brief Read the next line, without its line break.
+     * @param line Receives the line.
+     * @return false If the connection was closed before a whole line arrived, or the line is too long.
+     */
+    bool readLine(std::string &line) {
+        while (true) {
+            size_t end = buffer.find('\n', position);
+            if (end != std::string::npos) {
+                line.assign(buffer, position, end - position);
+                position = end + 1;
+                return true;
+            }
+
+            buffer.erase(0, position);
+            position = 0;
+            if (buffer.size() > max_line) {
+                return false;
+            }
+            char chunk[1 << 16];
+            ssize_t received = recv(socket_fd, chunk, sizeof(chunk), 0);
+            if (received < 0 && errno == EINTR) {
+                continue;
+            }
+            if (received <= 0) {
+                return false;
+            }
+            buffer.append(chunk, size_t(received));
+        }
+    }
+};
+
+/**
+ * @brief Send the whole text through a socket.
+ * @param socket_fd The connected socket.
+ * @param text The data to send.
+ * @return false If the connection failed.
+ */
+inline bool sendAll(int socket_fd, const std::string &text) {
+    size_t sent = 0;
+    while (sent < text.size()) {
+        ssize_t result = send(socket_fd, text.data() + sent, text.size() - sent, MSG_NOSIGNAL);
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result <= 0) {
+            return false;
+        }
+        sent += size_t(result);
+    }
+    return true;
+}
+
+/**
+ * @brief Fill a Unix domain socket address.
+ * @param path The file system path of the socket.
+ * @param address Receives the address.
+ * @return false If the path is too long.
+ */
+inline bool makeSocketAddress(const std::string &path, sockaddr_un &address) {
+    address = sockaddr_un();
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    path.copy(address.sun_path, path.size());
+    return true;
+}
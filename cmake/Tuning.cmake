@@ -0,0 +1,66 @@
+# Usage :
+#
+# Variable : ENABLE_NATIVE | Compile for the instruction set of the building machine (-march=native)
+# Variable : PGO_MODE      | Profile-guided optimization: OFF, GENERATE (instrumented build) or USE
+# Variable : PGO_DIR       | Directory of the collected profiles
+#
+# target_enable_tuning(target)
+# - adds the flags chosen by the variables above to the target (compile and link)
+#
+# A PGO build is done in three steps in the same build directory:
+#
+#       cmake -DPGO_MODE=GENERATE ..    # build, then run the training workload
+#       cmake -DPGO_MODE=USE ..         # rebuild using the profiles
+#
+# GCC reads the .gcda files straight from PGO_DIR. Clang writes .profraw files,
+# which have to be merged into PGO_DIR/default.profdata with llvm-profdata
+# before the USE build (run_bench.py does both).
+#
+# Native and PGO builds are supported for GCC and Clang only; with other
+# compilers the variables are ignored with a warning.
+
+set(__tuning_compile_flags "")
+set(__tuning_link_flags "")
+
+if(CMAKE_CXX_COMPILER_ID STREQUAL "GNU" OR CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+    if(ENABLE_NATIVE)
+        include(CheckCXXCompilerFlag)
+        check_cxx_compiler_flag(-march=native __native_supported)
+        if(__native_supported)
+            list(APPEND __tuning_compile_flags -march=native)
+        else()
+            message(WARNING "ENABLE_NATIVE: the compiler does not accept -march=native")
+        endif()
+    endif()
+
+    if(PGO_MODE STREQUAL "GENERATE")
+        file(MAKE_DIRECTORY "${PGO_DIR}")
+        list(APPEND __tuning_compile_flags -fprofile-generate=${PGO_DIR})
+        list(APPEND __tuning_link_flags -fprofile-generate=${PGO_DIR})
+        if(CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
+            # The solvers run on several threads.
+            list(APPEND __tuning_compile_flags -fprofile-update=atomic)
+        endif()
+    elseif(PGO_MODE STREQUAL "USE")
+        if(CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
+            # Targets not run during training (like the tests) have no profile.
+            list(APPEND __tuning_compile_flags -fprofile-use=${PGO_DIR} -fprofile-correction -Wno-missing-profile)
+        else()
+            if(NOT EXISTS "${PGO_DIR}/default.profdata")
+                message(FATAL_ERROR "PGO_MODE=USE: ${PGO_DIR}/default.profdata not found, merge the profiles first")
+            endif()
+            list(APPEND __tuning_compile_flags -fprofile-use=${PGO_DIR}/default.profdata
+                 -Wno-profile-instr-unprofiled -Wno-profile-instr-out-of-date)
+        endif()
+        list(APPEND __tuning_link_flags -fprofile-use)
+    elseif(NOT PGO_MODE STREQUAL "OFF")
+        message(FATAL_ERROR "PGO_MODE must be OFF, GENERATE or USE (got ${PGO_MODE})")
+    endif()
+elseif(ENABLE_NATIVE OR NOT PGO_MODE STREQUAL "OFF")
+    message(WARNING "ENABLE_NATIVE and PGO_MODE are only supported with GCC and Clang, ignoring them")
+endif()
+
+macro(target_enable_tuning _target)
+    target_compile_options(${_target} PRIVATE ${__tuning_compile_flags})
+    target_link_options(${_target} PRIVATE ${__tuning_link_flags})
+endmacro()
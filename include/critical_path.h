@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief The critical path of an order, in the sense of Carlier.
+ *
+ * The critical item b is the last one for which finish + idle time equals
+ * the total time. The block is the run of items b belongs to that the
+ * machine does without a break, starting at position a (which starts at its
+ * own occurrence time). The interference item c is the last item of the
+ * block before b with a shorter idle time than b.
+ *
+ * The order is optimal when there is no interference item and no item of
+ * the block occurs before a: the total time is then the smallest occurrence
+ * time of the block + its work + the idle time of b, a lower bound for
+ * these items in any order. Schrage orders always meet the second
+ * condition, other orders need not.
+ */
+struct CriticalPath {
+    static constexpr std::size_t NONE = std::size_t(-1); ///< Value of interference when there is no such item.
+
+    int time = 0; ///< Total time of the order.
+    std::size_t critical = 0; ///< Position b of the critical item.
+    std::size_t block_begin = 0; ///< Position a of the first item of the critical block.
+    std::size_t interference = NONE; ///< Position c of the interference item, or NONE.
+    bool block_starts_earliest = true; ///< Whether no item of the block occurs before the one at a.
+
+    /**
+     * @brief Check whether the analysis proves the order optimal.
+     * @return true If there is no interference item and the block starts with its earliest item.
+     */
+    bool isOptimal() const { return interference == NONE && block_starts_earliest; }
+};
+
+/**
+ * @brief Compute the finish times and the critical path of an order.
+ *
+ * One pass forward computes the finish times, the total time, the critical
+ * item and its block; one pass backward over the block finds the
+ * interference item and checks the occurrence times. Nothing is allocated if finish_times already has room
+ * for all items, so a search reusing the buffer runs without allocation.
+ *
+ * @tparam Item The type of items in the problem.
+ * @param order The items in the order to analyse.
+ * @param finish_times Receives the finish time of every position (resized to the size of order).
+ * @return The critical path (time 0 and optimal for an empty order).
+ */
+template<class Item>
+CriticalPath analyseCriticalPath(const std::vector<Item> &order, std::vector<int> &finish_times);
+
+#ifdef ENABLE_DOCTEST_IN_LIBRARY
+
+#include "doctest/doctest.h"
+#include "item.h"
+
+TEST_CASE("analyseCriticalPath") {
+    std::vector<int> finish_times;
+
+    SUBCASE("Schrage order of the test data has no interference") {
+        std::vector<Item<int>> order = {Item<int>(1, 1, 5, 9), Item<int>(5, 3, 6, 8), Item<int>(3, 1, 4, 6),
+                                        Item<int>(2, 4, 5, 4), Item<int>(4, 7, 3, 3), Item<int>(6, 4, 7, 1)};
+        CriticalPath path = analyseCriticalPath(order, finish_times);
+        CHECK(path.time == 32);
+        CHECK(finish_times == std::vector<int>{6, 12, 16, 21, 24, 31});
+        CHECK(path.critical == 5);
+        CHECK(path.block_begin == 0);
+        CHECK(path.isOptimal());
+    }
+
+    SUBCASE("Interference item and blocks after a break") {
+        std::vector<Item<int>> order = {Item<int>(1, 0, 2, 0), Item<int>(2, 10, 5, 1), Item<int>(3, 10, 1, 20),
+                                        Item<int>(4, 12, 1, 2)};
+        CriticalPath path = analyseCriticalPath(order, finish_times);
+        CHECK(path.time == 36);
+        CHECK(path.critical == 2);
+        CHECK(path.block_begin == 1);
+        CHECK(path.interference == 1);
+        CHECK_FALSE(path.isOptimal());
+    }
+
+    SUBCASE("An item occurring before the start of the block") {
+        // No interference item, but the order is not optimal: the reverse
+        // one takes 11.
+        std::vector<Item<int>> order = {Item<int>(1, 5, 1, 5), Item<int>(2, 0, 1, 5)};
+        CriticalPath path = analyseCriticalPath(order, finish_times);
+        CHECK(path.time == 12);
+        CHECK(path.interference == CriticalPath::NONE);
+        CHECK_FALSE(path.block_starts_earliest);
+        CHECK_FALSE(path.isOptimal());
+
+        std::swap(order[0], order[1]);
+        path = analyseCriticalPath(order, finish_times);
+        CHECK(path.time == 11);
+        CHECK(path.isOptimal());
+    }
+
+    SUBCASE("Empty order") {
+        CriticalPath path = analyseCriticalPath(std::vector<Item<int>>(), finish_times);
+        CHECK(path.time == 0);
+        CHECK(finish_times.empty());
+        CHECK(path.isOptimal());
+    }
+}
+
+#endif
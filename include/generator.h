@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Generate a random list of items.
+ *
+ * Work times are drawn from [1, max_work_time], occurrence and idle times
+ * from [0, max_occur_time] and [0, max_idle_time]. A negative limit means
+ * count * max_work_time / 2, which spreads the occurrence times over about
+ * half of the total work. Items get IDs 1..count. The same seed gives the
+ * same list on every platform.
+ *
+ * @tparam Item The type of items in the problem.
+ * @param count The number of items.
+ * @param seed The seed of the random generator.
+ * @param max_work_time The largest work time.
+ * @param max_occur_time The largest occurrence time.
+ * @param max_idle_time The largest idle time.
+ * @return The generated items.
+ */
+template<class Item>
+std::vector<Item> generateInstance(std::size_t count, uint32_t seed, int max_work_time = 30, int max_occur_time = -1,
+                                   int max_idle_time = -1);
+
+#ifdef ENABLE_DOCTEST_IN_LIBRARY
+
+#include "doctest/doctest.h"
+#include "item.h"
+
+TEST_CASE("generateInstance") {
+    std::vector<Item<int>> first = generateInstance<Item<int>>(50, 7, 10);
+    std::vector<Item<int>> second = generateInstance<Item<int>>(50, 7, 10);
+
+    REQUIRE(first.size() == 50);
+    bool same = true;
+    for (size_t i = 0; i < first.size(); i++) {
+        same = same && first[i].getId() == int(i) + 1 && first[i].getOccurTime() == second[i].getOccurTime() &&
+               first[i].getWorkTime() == second[i].getWorkTime() &&
+               first[i].getIdleTime() == second[i].getIdleTime();
+        CHECK(first[i].getWorkTime() >= 1);
+        CHECK(first[i].getWorkTime() <= 10);
+        CHECK(first[i].getOccurTime() <= 250);
+    }
+    CHECK(same);
+}
+
+#endif
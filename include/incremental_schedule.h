@@ -0,0 +1,339 @@
+#pragma once
+
+#include <cstddef>
+#include <set>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Segment tree over the positions of a schedule.
+ *
+ * Every position holds the occurrence time of its item and its finish +
+ * idle time. The tree gives the largest finish + idle time (the total time)
+ * and finds the positions from a given one on whose items occurred by a
+ * given moment, in time proportional to their number times log n.
+ */
+class PositionTree {
+private:
+    std::size_t leaves; /**< Number of leaves (a power of two). */
+    std::vector<int> earliest; /**< Smallest occurrence time below every node (node 1 is the root). */
+    std::vector<int> latest_end; /**< Largest finish + idle time below every node. */
+
+    /**
+     * @brief Collect the positions of a subtree.
+     * @param node The root of the subtree.
+     * @param begin The first position below it.
+     * @param end One past the last position below it.
+     * @param first The first position wanted.
+     * @param time The moment the items must have occurred by.
+     * @param positions Receives the positions.
+     */
+    void collect(std::size_t node, std::size_t begin, std::size_t end, std::size_t first, int time,
+                 std::vector<int> &positions) const;
+
+public:
+    /**
+     * @brief Constructor for an empty tree.
+     */
+    PositionTree();
+
+    /**
+     * @brief Make room for a number of positions (new ones are empty).
+     * @param size The number of positions.
+     */
+    void reserve(std::size_t size);
+
+    /**
+     * @brief Set a position without updating the nodes above it (see update).
+     * @param at The position.
+     * @param occur_time The occurrence time of its item.
+     * @param end_time The finish + idle time of its item.
+     */
+    void set(std::size_t at, int occur_time, int end_time) {
+        earliest[leaves + at] = occur_time;
+        latest_end[leaves + at] = end_time;
+    }
+
+    /**
+     * @brief Empty a position without updating the nodes above it (see update).
+     * @param at The position.
+     */
+    void clear(std::size_t at);
+
+    /**
+     * @brief Update the nodes above a range of positions.
+     * @param first The first position set or cleared.
+     * @param last One past the last one.
+     */
+    void update(std::size_t first, std::size_t last);
+
+    /**
+     * @brief Get the largest finish + idle time.
+     * @return The largest value over all positions.
+     */
+    int latestEnd() const { return latest_end[1]; }
+
+    /**
+     * @brief Find the positions from a given one on whose items occurred by a moment.
+     * @param first The first position.
+     * @param time The moment.
+     * @param positions Receives the positions, in increasing order.
+     */
+    void findOccurred(std::size_t first, int time, std::vector<int> &positions) const;
+};
+
+/**
+ * @brief A Schrage schedule kept up to date while items are added, removed and changed.
+ *
+ * Besides the order, the schedule keeps for every position the moment the
+ * decision was made (the start time) and the finish time (head), and a
+ * PositionTree holds the occurrence and finish + idle time of every position,
+ * so the total time is its largest end time.
+ *
+ * Changes are collected and the schedule is repaired when it is next read.
+ * The Schrage decisions before the first position a change can influence
+ * stay as they are; from there the algorithm runs again until it reaches the
+ * same moment with the same items left as the old schedule, and the rest of
+ * the old schedule is reused. A change of an item is felt first at its old
+ * position or at the first decision made after it occurs, whichever is
+ * earlier, and both are found by binary search over the decision times.
+ *
+ * A repair costs O((d + w + k) log n) for the d decisions made again, the w
+ * items waiting at the first affected position (found in the PositionTree)
+ * and the k changed items: the occurrence order is a set, the items that
+ * occur later are taken from it one by one, and only the repaired positions
+ * of the tree are updated. When items are added or removed, the number of
+ * positions changes and the rest of the schedule moves: that part is a
+ * plain linear pass (moving integers and the tree leaves behind the repair).
+ *
+ * Waiting items are chosen by the longest idle time, then by the lowest ID,
+ * so the order is the one MachineScheduler finds on one machine for a list
+ * sorted by ID.
+ *
+ * @tparam Item The type of items in the problem.
+ */
+template<class Item>
+class IncrementalSchedule {
+private:
+    static constexpr std::size_t NOTHING_AFFECTED = std::size_t(-1); /**< first_affected when there are no changes. */
+
+    std::vector<Item> items; /**< Items by slot. */
+    std::vector<char> live; /**< Whether a slot holds a current item. */
+    std::vector<int> free_slots; /**< Slots to reuse. */
+    std::unordered_map<int, int> slot_of_id; /**< Slot of every current item. */
+    std::set<std::tuple<int, int, int>> by_occur_time; /**< (occurrence time, ID, slot) of every current item. */
+
+    std::vector<int> order; /**< Slots in the order of the schedule. */
+    std::vector<int> decision; /**< Start time of every position. */
+    std::vector<int> finish; /**< Finish time (head) of every position. */
+    PositionTree tree; /**< Occurrence and finish + idle time of every position. */
+    std::vector<int> position; /**< Position of every slot in the schedule (-1 if added since the last repair). */
+
+    std::size_t first_affected; /**< First position changes can influence (NOTHING_AFFECTED if none). */
+    std::vector<int> touched; /**< Slots added, removed or changed since the last repair. */
+    std::vector<char> is_touched; /**< Whether a slot is in touched. */
+    std::vector<int> removed; /**< Slots removed since the last repair, freed after it. */
+    std::vector<int> mark; /**< Balance of every slot between the new and the old schedule during a repair. */
+    std::size_t repaired_count; /**< Decisions made again by the last repair. */
+
+    std::multiset<int> longest_items; /**< Occurrence + work + idle time of every item. */
+    std::multiset<int> occur_times; /**< Occurrence times of the items. */
+    std::multiset<int> idle_times; /**< Idle times of the items. */
+    long long total_work; /**< Sum of the work times. */
+
+    std::vector<int> ready; /**< Heap of waiting slots used by a repair. */
+    std::vector<int> waiting_positions; /**< Positions of the waiting items found by a repair. */
+    std::vector<int> new_order; /**< Repaired part of the order. */
+    std::vector<int> new_decision; /**< Repaired part of the decision times. */
+    std::vector<int> new_finish; /**< Repaired part of the finish times. */
+
+    /**
+     * @brief Find the first decision made at or after a moment.
+     * @param time The moment.
+     * @return The position of that decision (the size of the schedule if none).
+     */
+    std::size_t firstDecisionFrom(int time) const;
+
+    /**
+     * @brief Note that a change is felt from a position on.
+     * @param at The position.
+     */
+    void affect(std::size_t at);
+
+    /**
+     * @brief Remember that a slot takes part in the next repair.
+     * @param slot The slot.
+     */
+    void touch(int slot);
+
+    /**
+     * @brief Put an item in a free slot.
+     * @param item The item (with an ID not yet used).
+     * @return The slot.
+     */
+    int store(const Item &item);
+
+    /**
+     * @brief Add to or remove from the lower bound sums and the occurrence order.
+     * @param slot The slot of the item.
+     * @param add true to add the item, false to remove it.
+     */
+    void account(int slot, bool add);
+
+    /**
+     * @brief Run Schrage again from the first affected position.
+     */
+    void repair();
+
+public:
+    /**
+     * @brief Constructor for an empty schedule.
+     */
+    IncrementalSchedule();
+
+    /**
+     * @brief Constructor scheduling a list of items.
+     * @param items_s The items (with distinct IDs).
+     */
+    explicit IncrementalSchedule(const std::vector<Item> &items_s);
+
+    /**
+     * @brief Add an item.
+     * @param item The item.
+     * @return false If an item with the same ID is already scheduled.
+     */
+    bool addItem(const Item &item);
+
+    /**
+     * @brief Remove an item.
+     * @param id The ID of the item.
+     * @return false If there is no such item.
+     */
+    bool removeItem(int id);
+
+    /**
+     * @brief Replace an item with one of the same ID (new occurrence, work or idle time).
+     * @param item The new version of the item.
+     * @return false If there is no item with its ID.
+     */
+    bool updateItem(const Item &item);
+
+    /**
+     * @brief Get the number of items.
+     * @return The number of items.
+     */
+    std::size_t getSize() const { return slot_of_id.size(); }
+
+    /**
+     * @brief Get the total time of the schedule.
+     * @return The total time (0 if there are no items).
+     */
+    int getTime();
+
+    /**
+     * @brief Get the items in the order of the schedule.
+     * @param scheduled Receives the items.
+     */
+    void getOrder(std::vector<Item> &scheduled);
+
+    /**
+     * @brief Get the lower bound of the total time.
+     *
+     * The larger of the longest single item and the smallest occurrence
+     * time + all work + the smallest idle time.
+     *
+     * @return The lower bound (0 if there are no items).
+     */
+    int getLowerBound() const;
+
+    /**
+     * @brief Get the number of decisions made again by the last repair.
+     * @return The number of decisions.
+     */
+    std::size_t getRepairedCount() const { return repaired_count; }
+};
+
+#ifdef ENABLE_DOCTEST_IN_LIBRARY
+
+#include "doctest/doctest.h"
+#include "item.h"
+#include "generator.h"
+#include "multi_machine.h"
+
+TEST_CASE("IncrementalSchedule") {
+    std::vector<Item<int>> items = generateInstance<Item<int>>(300, 11, 20);
+    IncrementalSchedule<Item<int>> schedule(items);
+    std::vector<Item<int>> scheduled;
+
+    // Schedules the current items from scratch and compares the orders.
+    auto matchesFullSolve = [&]() {
+        std::vector<Item<int>> current = items;
+        std::sort(current.begin(), current.end());
+        MachineScheduler<Item<int>> scheduler(1);
+        MachineSchedule full;
+        int time = scheduler.dispatch(current, full);
+
+        schedule.getOrder(scheduled);
+        bool same = time == schedule.getTime() && scheduled.size() == current.size();
+        for (size_t i = 0; same && i < scheduled.size(); i++) {
+            same = scheduled[i].getId() == current[full.order[i]].getId();
+        }
+        return same;
+    };
+
+    CHECK(matchesFullSolve());
+    CHECK(schedule.getTime() >= schedule.getLowerBound());
+
+    SUBCASE("Single changes") {
+        Item<int> late(1000, 5000, 10, 3);
+        CHECK(schedule.addItem(late));
+        CHECK_FALSE(schedule.addItem(late));
+        items.push_back(late);
+        CHECK(matchesFullSolve());
+        CHECK(schedule.getRepairedCount() < 10);
+
+        CHECK(schedule.removeItem(1000));
+        CHECK_FALSE(schedule.removeItem(1000));
+        items.pop_back();
+        CHECK(matchesFullSolve());
+
+        items[17] = Item<int>(items[17].getId(), 0, items[17].getWorkTime(), 5000);
+        CHECK(schedule.updateItem(items[17]));
+        CHECK(matchesFullSolve());
+    }
+
+    SUBCASE("Batches of random changes") {
+        std::vector<Item<int>> extra = generateInstance<Item<int>>(100, 12, 20, 3000, 3000);
+        bool all_same = true;
+        for (int round = 0; round < 50; round++) {
+            int changes = 1 + round % 5;
+            for (int c = 0; c < changes; c++) {
+                size_t victim = size_t(round * 37 + c * 11) % items.size();
+                Item<int> &old_item = items[victim];
+                switch ((round + c) % 3) {
+                    case 0:
+                        schedule.removeItem(old_item.getId());
+                        items.erase(items.begin() + long(victim));
+                        break;
+                    case 1:
+                        old_item = Item<int>(old_item.getId(), (old_item.getOccurTime() * 7) % 3000,
+                                             old_item.getWorkTime(), (old_item.getIdleTime() * 3) % 3000);
+                        schedule.updateItem(old_item);
+                        break;
+                    default:
+                        Item<int> added(10000 + round * 10 + c, extra[size_t(round)].getOccurTime(),
+                                        extra[size_t(round)].getWorkTime(), extra[size_t(round)].getIdleTime());
+                        schedule.addItem(added);
+                        items.push_back(added);
+                        break;
+                }
+            }
+            all_same = all_same && matchesFullSolve();
+        }
+        CHECK(all_same);
+        CHECK(schedule.getSize() == items.size());
+    }
+}
+
+#endif
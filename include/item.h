@@ -6,15 +6,18 @@
  * @brief A class representing an item with attributes like ID, occurrence time,
  * work time, and idle time.
  *
- * @tparam T The type of the item (currently unused).
+ * All four values are stored as T and read back as int, so Item<int> takes 16
+ * bytes and Item<short> 8 bytes (for IDs and times up to 32767).
+ *
+ * @tparam T The type storing the ID and the times.
  */
 template<class T>
 class Item {
 private:
-    int id; ///< The unique identifier of the item.
-    int occur_time; ///< The time at which the item occurs.
-    int work_time; ///< The time required to process the item.
-    int idle_time; ///< The idle time associated with the item.
+    T id; ///< The unique identifier of the item.
+    T occur_time; ///< The time at which the item occurs.
+    T work_time; ///< The time required to process the item.
+    T idle_time; ///< The idle time associated with the item.
 
 public:
     /**
@@ -58,14 +61,14 @@ public:
    *
    * @return int The idle time associated with the item.
    */
-    void setWorkTime(int work_time_s) { work_time = work_time_s; }
+    void setWorkTime(int work_time_s) { work_time = T(work_time_s); }
 
     /**
    * @brief Getter method for the idle time associated with the item.
    *
    * @return int The idle time associated with the item.
    */
-    void workTimeDecrement() { work_time -= 1; }
+    void workTimeDecrement() { work_time = T(work_time - 1); }
 
     /**
    * @brief Getter method for the idle time associated with the item.
@@ -79,7 +82,7 @@ public:
    *
    * @return int The idle time associated with the item.
    */
-    void setIdleTime(int idle_time_s) { idle_time = idle_time_s; }
+    void setIdleTime(int idle_time_s) { idle_time = T(idle_time_s); }
 
     /**
     * @brief Overloaded less than operator for comparing items based on their IDs.
@@ -156,6 +159,14 @@ TEST_CASE("Item class") {
     CHECK(item1 < item2);
     CHECK(item1.compareByOccurTime(item2));
     CHECK(item1.compareByIdleTime(item2));
+
+    // Compact layout
+    CHECK(sizeof(Item<int>) == 16);
+    CHECK(sizeof(Item<short>) == 8);
+    Item<short> compact(3, 30000, 5, 2);
+    compact.workTimeDecrement();
+    CHECK(compact.getOccurTime() == 30000);
+    CHECK(compact.getWorkTime() == 4);
 }
 
 #endif
\ No newline at end of file
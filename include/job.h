@@ -0,0 +1,270 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Checks whether a type can be read like an item.
+ *
+ * Required: getId(), getOccurTime(), getWorkTime() and getIdleTime() callable
+ * on a const object and convertible to int, a default constructor, copying
+ * and a constructor taking (id, occurrence, work, idle time) as ints.
+ *
+ * @tparam Job The type to check.
+ */
+template<class Job, class = void>
+struct has_job_accessors : std::false_type {};
+
+template<class Job>
+struct has_job_accessors<Job, std::void_t<decltype(int(std::declval<const Job &>().getId())),
+                                          decltype(int(std::declval<const Job &>().getOccurTime())),
+                                          decltype(int(std::declval<const Job &>().getWorkTime())),
+                                          decltype(int(std::declval<const Job &>().getIdleTime()))>>
+    : std::integral_constant<bool, std::is_default_constructible<Job>::value && std::is_copy_assignable<Job>::value &&
+                                       std::is_constructible<Job, int, int, int, int>::value> {};
+
+/**
+ * @brief Checks whether a type can be changed by the algorithms that split items.
+ *
+ * Required: setWorkTime(int), workTimeDecrement() and setIdleTime(int). They
+ * must change only the object they are called on, not its copies.
+ *
+ * @tparam Job The type to check.
+ */
+template<class Job, class = void>
+struct has_job_mutators : std::false_type {};
+
+template<class Job>
+struct has_job_mutators<Job, std::void_t<decltype(std::declval<Job &>().setWorkTime(0)),
+                                         decltype(std::declval<Job &>().workTimeDecrement()),
+                                         decltype(std::declval<Job &>().setIdleTime(0))>> : std::true_type {};
+
+/**
+ * @brief Checks whether a type can be ordered like an item.
+ *
+ * Required: operator< (by ID), compareByOccurTime and compareByIdleTime, all
+ * callable on const objects and returning something convertible to bool.
+ *
+ * @tparam Job The type to check.
+ */
+template<class Job, class = void>
+struct has_job_comparisons : std::false_type {};
+
+template<class Job>
+struct has_job_comparisons<Job, std::void_t<decltype(bool(std::declval<const Job &>() < std::declval<const Job &>())),
+                                            decltype(bool(std::declval<const Job &>().compareByOccurTime(
+                                                std::declval<const Job &>()))),
+                                            decltype(bool(std::declval<const Job &>().compareByIdleTime(
+                                                std::declval<const Job &>())))>> : std::true_type {};
+
+/**
+ * @brief Checks whether a type can be used as the items of Problem.
+ * @tparam Job The type to check.
+ */
+template<class Job>
+struct is_job : std::integral_constant<bool, has_job_accessors<Job>::value && has_job_mutators<Job>::value &&
+                                                 has_job_comparisons<Job>::value> {};
+
+/**
+ * @brief Columns of the items referred to by SoaJob.
+ *
+ * Every thread has its own store, so a SoaJob can only be read on the
+ * thread that created it; solvers using threads copy the times to ints
+ * before starting them. Row 0 is the default item (all zeros).
+ * Rows are only added, so a SoaJob stays valid until its row is truncated.
+ * Algorithms add a row for every item they change; the WorkspaceLease of a
+ * Problem<SoaJob> algorithm truncates them when the algorithm ends. Rows of
+ * the items a program creates stay until it truncates them itself, once no
+ * SoaJob of the thread refers to them.
+ */
+class SoaJobStore {
+public:
+    std::vector<int> id; ///< IDs by row.
+    std::vector<int> occur_time; ///< Occurrence times by row.
+    std::vector<int> work_time; ///< Work times by row.
+    std::vector<int> idle_time; ///< Idle times by row.
+
+    /**
+     * @brief Constructor creating the default row.
+     */
+    SoaJobStore();
+
+    /**
+     * @brief Get the store of the calling thread.
+     * @return The store.
+     */
+    static SoaJobStore &local() {
+        thread_local SoaJobStore store;
+        return store;
+    }
+
+    /**
+     * @brief Add a row.
+     * @param id_s The ID.
+     * @param occur_time_s The occurrence time.
+     * @param work_time_s The work time.
+     * @param idle_time_s The idle time.
+     * @return The index of the row.
+     */
+    uint32_t add(int id_s, int occur_time_s, int work_time_s, int idle_time_s);
+
+    /**
+     * @brief Remove the rows from the given one on, keeping the memory.
+     *
+     * Only allowed when no SoaJob of this thread in use refers to them.
+     *
+     * @param rows The number of rows to keep (at least the default row is kept).
+     */
+    void truncate(std::size_t rows = 1);
+
+    /**
+     * @brief Get the number of rows.
+     * @return The number of rows (at least 1).
+     */
+    std::size_t size() const { return id.size(); }
+};
+
+/**
+ * @brief An item stored as a row index into the SoaJobStore of the thread.
+ *
+ * Sorting and queueing moves 8 bytes per item and the times of all items lie
+ * in separate arrays. Copies share their row. Changing an item writes to its
+ * own new row the first time and in place after that, unless the item was
+ * copied in the meantime, so copies never see each other's changes and an
+ * item whose work time is counted down does not add a row on every step.
+ */
+class SoaJob {
+private:
+    uint32_t row; /**< The row of the item in the store. */
+    mutable bool owned; /**< Whether no other SoaJob shares the row (it can be changed in place). */
+
+    /**
+     * @brief Make sure the row belongs only to this item before changing it.
+     * @return The columns to write to.
+     */
+    SoaJobStore &own();
+
+    /**
+     * @brief Get the store of the thread, checking in debug builds that the row is in it.
+     * @return The columns to read from.
+     */
+    const SoaJobStore &store() const {
+        const SoaJobStore &local = SoaJobStore::local();
+        assert(row < local.size() && "SoaJob read after its row was truncated or on another thread");
+        return local;
+    }
+
+public:
+    /**
+     * @brief Default constructor referring to the default row.
+     */
+    SoaJob() : row(0), owned(false) {}
+
+    /**
+     * @brief Constructor adding a row to the store of the thread.
+     * @param id_s The ID.
+     * @param occur_time_s The occurrence time.
+     * @param work_time_s The work time.
+     * @param idle_time_s The idle time.
+     */
+    SoaJob(int id_s, int occur_time_s, int work_time_s, int idle_time_s)
+        : row(SoaJobStore::local().add(id_s, occur_time_s, work_time_s, idle_time_s)), owned(true) {}
+
+    SoaJob(const SoaJob &other) : row(other.row), owned(false) { other.owned = false; }
+
+    SoaJob &operator=(const SoaJob &other) {
+        row = other.row;
+        owned = false;
+        other.owned = false;
+        return *this;
+    }
+
+    int getId() const { return store().id[row]; }
+
+    int getOccurTime() const { return store().occur_time[row]; }
+
+    int getWorkTime() const { return store().work_time[row]; }
+
+    int getIdleTime() const { return store().idle_time[row]; }
+
+    void setWorkTime(int work_time_s) { own().work_time[row] = work_time_s; }
+
+    void workTimeDecrement() { own().work_time[row]--; }
+
+    void setIdleTime(int idle_time_s) { own().idle_time[row] = idle_time_s; }
+
+    bool operator<(const SoaJob &other) const { return getId() < other.getId(); }
+
+    bool compareByOccurTime(const SoaJob &other) const { return getOccurTime() < other.getOccurTime(); }
+
+    bool compareByIdleTime(const SoaJob &other) const { return getIdleTime() < other.getIdleTime(); }
+};
+
+/**
+ * @brief Removes the rows added to the item store while it exists; nothing for items owning their times.
+ *
+ * Only rows no item outside the scope refers to may be added inside it.
+ *
+ * @tparam Job The type of items.
+ */
+template<class Job>
+class JobRowScope {};
+
+template<>
+class JobRowScope<SoaJob> {
+private:
+    std::size_t rows; /**< Rows of the store when the scope began. */
+
+public:
+    JobRowScope() : rows(SoaJobStore::local().size()) {}
+
+    ~JobRowScope() { SoaJobStore::local().truncate(rows); }
+
+    JobRowScope(const JobRowScope &) = delete;
+    JobRowScope &operator=(const JobRowScope &) = delete;
+};
+
+#ifdef ENABLE_DOCTEST_IN_LIBRARY
+
+#include "doctest/doctest.h"
+#include "item.h"
+
+TEST_CASE("Job types") {
+    CHECK(is_job<Item<int>>::value);
+    CHECK(is_job<Item<short>>::value);
+    CHECK(is_job<SoaJob>::value);
+    CHECK_FALSE(is_job<int>::value);
+    CHECK_FALSE(has_job_mutators<const Item<int>>::value);
+
+    SoaJob first(1, 10, 5, 2);
+    SoaJob copy = first;
+    std::size_t rows = SoaJobStore::local().size();
+
+    copy.workTimeDecrement();
+    copy.workTimeDecrement();
+    CHECK(copy.getWorkTime() == 3);
+    CHECK(first.getWorkTime() == 5);
+    CHECK(SoaJobStore::local().size() == rows + 1);
+
+    first.setIdleTime(0);
+    CHECK(copy.getIdleTime() == 2);
+    CHECK(first.getIdleTime() == 0);
+    CHECK(first.getId() == 1);
+    CHECK(copy.compareByIdleTime(SoaJob(2, 0, 1, 3)));
+
+    rows = SoaJobStore::local().size();
+    {
+        JobRowScope<SoaJob> scope;
+        SoaJob changed = first;
+        changed.setWorkTime(1);
+        CHECK(SoaJobStore::local().size() == rows + 1);
+    }
+    CHECK(SoaJobStore::local().size() == rows);
+    CHECK(first.getWorkTime() == 5);
+}
+
+#endif
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief A schedule of items on identical parallel machines.
+ */
+struct MachineSchedule {
+    std::vector<int> order; ///< Positions of the items (in the scheduled list) in the order they were started.
+    std::vector<int> machine; ///< Machine of every item, by position in the list.
+    std::vector<int> start; ///< Start time of every item, by position in the list.
+    int time = 0; ///< Total time: the latest moment an item finishes its idle time.
+};
+
+/**
+ * @brief Schrage dispatching on several identical machines.
+ *
+ * Whenever a machine becomes free, the waiting item with the longest idle
+ * time is started on it; if nothing is waiting, the machine waits for the
+ * next item to occur. Machines are kept in a heap by the moment they become
+ * free, and waiting items in a heap by idle time, so dispatching n items on
+ * m machines takes O(n log n + n log m). With one machine it is the Schrage
+ * algorithm without expropriation.
+ *
+ * The buffers are kept between calls, so dispatching many lists of similar
+ * size does not allocate.
+ *
+ * @tparam Item The type of items in the problem.
+ */
+template<class Item>
+class MachineScheduler {
+private:
+    int machine_count; /**< Number of machines. */
+    std::vector<int> by_occur_time; /**< Positions of items sorted by occurrence time. */
+    std::vector<std::pair<int, int>> waiting; /**< Heap of (idle time, -position) of waiting items. */
+    std::vector<std::pair<int, int>> machines; /**< Min-heap of (free from, machine). */
+    std::vector<int> machine_time; /**< Per-machine clock used by evaluate. */
+
+public:
+    /**
+     * @brief Constructor.
+     * @param machine_count_s Number of machines (at least 1).
+     */
+    explicit MachineScheduler(int machine_count_s);
+
+    /**
+     * @brief Get the number of machines.
+     * @return The number of machines.
+     */
+    int getMachineCount() const { return machine_count; }
+
+    /**
+     * @brief Dispatch the items on the machines.
+     * @param items The items to schedule.
+     * @param schedule Receives the schedule.
+     * @return The total time of the schedule.
+     */
+    int dispatch(const std::vector<Item> &items, MachineSchedule &schedule);
+
+    /**
+     * @brief Compute the total time of a schedule.
+     *
+     * Each machine runs its items in the order in which they appear in
+     * schedule.order, starting each one as early as possible; the start
+     * times stored in the schedule are not used.
+     *
+     * @param items The scheduled items.
+     * @param schedule The order and the machines of the items.
+     * @return The maximum over all machines of the moment their items finish their idle time.
+     */
+    int evaluate(const std::vector<Item> &items, const MachineSchedule &schedule);
+
+    /**
+     * @brief Compute a lower bound of the total time on the given number of machines.
+     *
+     * The larger of the longest single item (occurrence + work + idle time)
+     * and the load bound: if k machines are used, their summed total times
+     * cover all work plus at least the k smallest occurrence times and the k
+     * smallest idle times, so the total time is at least
+     * (work + k smallest occurrence + k smallest idle times) / k for the
+     * least favourable k.
+     *
+     * @param items The items.
+     * @param machine_count Number of machines.
+     * @return The lower bound.
+     */
+    static int lowerBound(const std::vector<Item> &items, int machine_count);
+};
+
+#ifdef ENABLE_DOCTEST_IN_LIBRARY
+
+#include "doctest/doctest.h"
+#include "item.h"
+#include "generator.h"
+
+TEST_CASE("MachineScheduler") {
+    std::vector<Item<int>> items = {Item<int>(1, 1, 5, 9), Item<int>(2, 4, 5, 4), Item<int>(3, 1, 4, 6),
+                                    Item<int>(4, 7, 3, 3), Item<int>(5, 3, 6, 8), Item<int>(6, 4, 7, 1)};
+    MachineSchedule schedule;
+
+    SUBCASE("One machine is the Schrage algorithm") {
+        MachineScheduler<Item<int>> scheduler(1);
+        CHECK(scheduler.dispatch(items, schedule) == 32);
+        CHECK(scheduler.evaluate(items, schedule) == 32);
+        CHECK(MachineScheduler<Item<int>>::lowerBound(items, 1) <= 32);
+    }
+
+    SUBCASE("Enough machines start every item when it occurs") {
+        MachineScheduler<Item<int>> scheduler(6);
+        CHECK(scheduler.dispatch(items, schedule) == 17);
+        CHECK(MachineScheduler<Item<int>>::lowerBound(items, 6) == 17);
+    }
+
+    SUBCASE("Schedules stay above the lower bound") {
+        std::vector<Item<int>> random_items = generateInstance<Item<int>>(200, 3);
+        for (int machine_count: {1, 2, 3, 8, 64}) {
+            MachineScheduler<Item<int>> scheduler(machine_count);
+            int time = scheduler.dispatch(random_items, schedule);
+            CHECK(time == scheduler.evaluate(random_items, schedule));
+            CHECK(time >= MachineScheduler<Item<int>>::lowerBound(random_items, machine_count));
+        }
+    }
+}
+
+#endif
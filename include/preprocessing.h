@@ -0,0 +1,204 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "item.h"
+#include "solve_control.h"
+
+/**
+ * @brief Part of an instance that can be solved on its own.
+ */
+struct ReductionBlock {
+    std::size_t first = 0; ///< Position of the first item of the block in the list sorted by occurrence time.
+    std::size_t size = 0; ///< Number of items in the block.
+    int occur_offset = 0; ///< Smallest occurrence time in the block, subtracted from all of them.
+    int idle_offset = 0; ///< Smallest idle time in the block, subtracted from all of them.
+};
+
+/**
+ * @brief The copy of an item read by the threads of InstanceReduction.
+ */
+using ReductionItem = Item<int>;
+
+/**
+ * @brief Splits an instance into independent blocks and solves them separately.
+ *
+ * Items are sorted by occurrence time. When all items up to some point can
+ * be finished (working without unnecessary breaks) before the next item
+ * occurs, the machine is forced to be idle there and the instance splits.
+ * Within each block the smallest occurrence and idle times are subtracted,
+ * which changes the total time of every order by the same amount.
+ *
+ * Blocks of one item are placed as they are. Blocks of up to
+ * TINY_SOLVER_LIMIT items go to solveTinyInstance, blocks of up to the exact
+ * limit to SubsetSolver, and larger ones are scheduled by Schrage (exact
+ * when analyseCriticalPath proves the order optimal). Blocks are
+ * solved on several threads, the largest first, and their orders are joined
+ * by occurrence time. The threads only read a copy of the items as
+ * ReductionItem, made by the constructor, so items read through the calling
+ * thread (like SoaJob) can be used too.
+ *
+ * The joined order is optimal when every block was solved exactly and no
+ * block's order runs past the occurrence of the next block: the total time
+ * is then the largest block total time, and no block can do better inside
+ * the whole instance than on its own.
+ *
+ * @tparam Item The type of items in the problem.
+ */
+template<class Item>
+class InstanceReduction {
+private:
+    std::vector<Item> sorted; /**< The items sorted by occurrence time, then ID. */
+    std::vector<ReductionItem> plain; /**< The sorted items as ReductionItem, the only copy the threads read. */
+    std::vector<ReductionBlock> blocks; /**< The blocks, in the order of the sorted list. */
+    std::size_t exact_limit; /**< Largest block solved exactly. */
+
+    /**
+     * @brief Solve one block.
+     * @param block The block.
+     * @param order Receives the positions of the items of the block in the sorted list, in the found order.
+     * @param thread_count Threads the block may use.
+     * @param block_exact_limit Largest block given to SubsetSolver.
+     * @param control Limits of SubsetSolver (may be null).
+     * @return true If the order is optimal for the block.
+     */
+    bool solveBlock(const ReductionBlock &block, std::vector<std::size_t> &order, unsigned thread_count,
+                    std::size_t block_exact_limit, SolveControl *control) const;
+
+public:
+    /**
+     * @brief Constructor splitting the instance.
+     * @param items The items.
+     * @param exact_limit_s Largest block solved exactly (at most SUBSET_SOLVER_LIMIT).
+     */
+    explicit InstanceReduction(const std::vector<Item> &items, std::size_t exact_limit_s = 20);
+
+    /**
+     * @brief Get the blocks.
+     * @return The blocks, in the order of occurrence.
+     */
+    const std::vector<ReductionBlock> &getBlocks() const { return blocks; }
+
+    /**
+     * @brief Get the number of items in the largest block.
+     * @return The number of items.
+     */
+    std::size_t getLargestBlock() const;
+
+    /**
+     * @brief Get the items of a block with the offsets subtracted.
+     * @param block The index of the block.
+     * @param normalised Receives the items.
+     */
+    void getBlockItems(std::size_t block, std::vector<Item> &normalised) const;
+
+    /**
+     * @brief Solve all blocks and join their orders.
+     *
+     * Every block given to SubsetSolver gets its own part of the control
+     * (see SolveControl::part). Once one of them is stopped, the blocks
+     * solved after it are scheduled by Schrage instead, so the joined order
+     * is ready soon after the deadline. Nodes reported are the blocks.
+     *
+     * @param order Receives the items in the joined order.
+     * @param exact Receives whether the order is proven optimal.
+     * @param thread_count Number of threads (0 means all available).
+     * @param control Limits and progress reporting (may be null).
+     * @return The total time of the joined order.
+     */
+    int solve(std::vector<Item> &order, bool &exact, unsigned thread_count = 0, SolveControl *control = nullptr) const;
+};
+
+#ifdef ENABLE_DOCTEST_IN_LIBRARY
+
+#include "doctest/doctest.h"
+#include "job.h"
+
+TEST_CASE("InstanceReduction") {
+    // Two groups separated by a forced break, and a late item on its own.
+    std::vector<Item<int>> items = {Item<int>(1, 1, 5, 9),   Item<int>(2, 4, 5, 4),   Item<int>(3, 1, 4, 6),
+                                    Item<int>(4, 7, 3, 3),   Item<int>(5, 3, 6, 8),   Item<int>(6, 4, 7, 1),
+                                    Item<int>(7, 101, 5, 9), Item<int>(8, 104, 5, 4), Item<int>(9, 101, 4, 6),
+                                    Item<int>(10, 500, 2, 2)};
+    InstanceReduction<Item<int>> reduction(items);
+
+    REQUIRE(reduction.getBlocks().size() == 3);
+    CHECK(reduction.getLargestBlock() == 6);
+    CHECK(reduction.getBlocks()[1].occur_offset == 101);
+    CHECK(reduction.getBlocks()[1].idle_offset == 4);
+
+    std::vector<Item<int>> normalised;
+    reduction.getBlockItems(1, normalised);
+    CHECK(normalised[0].getOccurTime() == 0);
+
+    std::vector<Item<int>> order;
+    bool exact = false;
+    CHECK(reduction.solve(order, exact, 2) == 504);
+    CHECK(exact);
+    CHECK(order.size() == items.size());
+    CHECK(order.back().getId() == 10);
+
+    SUBCASE("Blocks running into the next one are not proven optimal") {
+        // The first block is best started with item 2, which leaves the
+        // machine idle and finishes after item 3 occurs.
+        std::vector<Item<int>> late = {Item<int>(1, 0, 3, 0), Item<int>(2, 1, 1, 100), Item<int>(3, 4, 1, 0)};
+        InstanceReduction<Item<int>> overlapping(late);
+        CHECK(overlapping.getBlocks().size() == 2);
+        CHECK(overlapping.solve(order, exact, 1) == 102);
+        CHECK_FALSE(exact);
+    }
+
+    SUBCASE("Stopping the exact blocks") {
+        std::vector<Item<int>> large;
+        for (int i = 0; i < 14; i++) {
+            large.emplace_back(i + 1, (i * 7) % 5, 5 + (i * 5) % 9, (i * 11) % 37);
+        }
+        large.emplace_back(15, 1000, 2, 2);
+        InstanceReduction<Item<int>> stopped(large);
+        REQUIRE(stopped.getBlocks().size() == 2);
+
+        SolveControl control;
+        control.setNodeLimit(1);
+        stopped.solve(order, exact, 1, &control);
+        CHECK(control.wasStopped());
+        CHECK_FALSE(exact);
+        CHECK(order.size() == large.size());
+
+        control.setNodeLimit(UINT64_MAX);
+        stopped.solve(order, exact, 1, &control);
+        CHECK_FALSE(control.wasStopped());
+        CHECK(exact);
+    }
+
+    SUBCASE("Items read through the calling thread on several threads") {
+        // Blocks of 1, 6 and 16 items (the last one split between threads
+        // by SubsetSolver), solved on 3 threads.
+        std::vector<Item<int>> many = items;
+        for (int i = 0; i < 16; i++) {
+            many.emplace_back(20 + i, 1000 + (i * 7) % 5, 5 + (i * 5) % 9, (i * 11) % 37);
+        }
+        std::vector<SoaJob> rows;
+        for (const Item<int> &item: many) {
+            rows.emplace_back(item.getId(), item.getOccurTime(), item.getWorkTime(), item.getIdleTime());
+        }
+        InstanceReduction<Item<int>> by_value(many);
+        InstanceReduction<SoaJob> by_row(rows);
+        REQUIRE(by_row.getBlocks().size() == 4);
+
+        bool row_exact = false;
+        std::vector<SoaJob> row_order;
+        int time = by_value.solve(order, exact, 1);
+        CHECK(by_row.solve(row_order, row_exact, 3) == time);
+        CHECK(row_exact == exact);
+        REQUIRE(row_order.size() == order.size());
+        bool same = true;
+        for (std::size_t i = 0; i < order.size(); i++) {
+            same = same && row_order[i].getId() == order[i].getId() &&
+                   row_order[i].getWorkTime() == order[i].getWorkTime();
+        }
+        CHECK(same);
+    }
+}
+
+#endif
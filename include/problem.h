@@ -8,8 +8,18 @@
 #include <queue>
 #include <chrono>
 #include <functional>
+#include <memory>
 
 #include "item.h"
+#include "job.h"
+#include "workspace.h"
+#include "tiny_solver.h"
+#include "subset_solver.h"
+#include "result_sink.h"
+#include "multi_machine.h"
+#include "preprocessing.h"
+#include "critical_path.h"
+#include "solve_control.h"
 
 /**
  * @brief A class representing a problem with a list of items.
@@ -18,13 +28,44 @@
  * including loading items from a file, performing various sorting
  * algorithms, calculating work time, and saving results to a file.
  *
+ * Any type passing is_job can be used as the items; the library is built for
+ * Item<int>, Item<short> (8-byte items, times up to 32767) and SoaJob (an
+ * index into columns of times).
+ *
  * @tparam Item The type of items in the problem.
  */
 template<class Item>
 class Problem {
+    static_assert(has_job_accessors<Item>::value,
+                  "Items need getId/getOccurTime/getWorkTime/getIdleTime and a (id, r, p, q) constructor");
+    static_assert(has_job_mutators<Item>::value, "Items need setWorkTime, workTimeDecrement and setIdleTime");
+    static_assert(has_job_comparisons<Item>::value, "Items need operator<, compareByOccurTime and compareByIdleTime");
+
 private:
     std::vector<Item> main_list; /**< The main list of items. */
     int list_size; /**< The size of the list. */
+    bool verbose; /**< Whether results are printed to the standard output. */
+    ScheduleResult result; /**< Result of the last algorithm (time -1 if none). */
+    ResultSink *result_sink; /**< Receives every result (not owned, may be null). */
+    ResultSink *permutation_log; /**< Receives every permutation visited by permutationSort (not owned, may be null). */
+    MachineSchedule machine_schedule; /**< Schedule found by the last parallel machine algorithm. */
+    SolveControl *solve_control; /**< Limits of the long-running algorithms (not owned, may be null). */
+    std::size_t memory_budget; /**< Largest memory subsetDynamicProgramming may take, in bytes. */
+    unsigned thread_count; /**< Threads of subsetDynamicProgramming and reducedSolve (0 means all available). */
+    std::unique_ptr<TextSink> saved_results; /**< File of savePermResult, kept open between calls. */
+    std::string saved_results_name; /**< Name of that file. */
+    ScheduleResult saved_line; /**< The record savePermResult writes, reused between calls. */
+
+    /**
+     * @brief Remember the result of an algorithm, pass it to the sink and print it if verbose.
+     * @param algorithm Short name of the algorithm.
+     * @param title The header printed above the result.
+     * @param order The order of items.
+     * @param time The total time (-1 if the algorithm refused the list; nothing is displayed then).
+     * @param complete false if the algorithm was stopped early or refused the list.
+     */
+    void reportResult(const char *algorithm, const char *title, const std::vector<Item> &order, int time,
+                      bool complete = true);
 
 public:
     /**
@@ -51,12 +92,104 @@ public:
      */
     void loadFromFile(const std::string &file_name);
 
+    /**
+     * @brief Load items from a stream in the same format as loadFromFile.
+     * @param input The stream to read from (until its end).
+     * @param error Receives the description of the problem if loading fails.
+     * @return true If the items were loaded.
+     */
+    bool loadFromStream(std::istream &input, std::string &error);
+
+    /**
+     * @brief Replace the list of items.
+     * @param items The new items.
+     */
+    void setItems(const std::vector<Item> &items);
+
+    /**
+     * @brief Choose whether algorithms print their results.
+     * @param verbose_s true to print (the default), false to only remember them.
+     */
+    void setVerbose(bool verbose_s) { verbose = verbose_s; }
+
+    /**
+     * @brief Get the order found by the last algorithm.
+     * @return The IDs of items in that order.
+     */
+    const std::vector<int> &getResultOrder() const { return result.order; }
+
+    /**
+     * @brief Get the total time found by the last algorithm.
+     * @return The total time, or -1 if no algorithm produced a result.
+     */
+    int getResultTime() const { return result.time; }
+
+    /**
+     * @brief Get the result of the last algorithm.
+     * @return The algorithm name, order and total time.
+     */
+    const ScheduleResult &getResult() const { return result; }
+
+    /**
+     * @brief Pass the result of every following algorithm to a sink.
+     * @param sink The sink (kept by the caller, must outlive its use), or nullptr to stop.
+     */
+    void setResultSink(ResultSink *sink) { result_sink = sink; }
+
+    /**
+     * @brief Log every permutation visited by permutationSort.
+     *
+     * While set, permutationSort visits all permutations instead of using
+     * solveTinyInstance.
+     *
+     * @param sink The sink (kept by the caller, must outlive its use), or nullptr to stop.
+     */
+    void setPermutationLog(ResultSink *sink) { permutation_log = sink; }
+
+    /**
+     * @brief Limit permutationSort, subsetDynamicProgramming and reducedSolve and receive their progress.
+     *
+     * When stopped, they report the best order found so far and mark the
+     * result as not complete.
+     *
+     * @param control The control (kept by the caller, must outlive its use), or nullptr for none.
+     */
+    void setSolveControl(SolveControl *control) { solve_control = control; }
+
+    /**
+     * @brief Limit the memory of subsetDynamicProgramming.
+     * @param bytes The largest memory its tables may take (SUBSET_SOLVER_MEMORY_BUDGET by default).
+     */
+    void setMemoryBudget(std::size_t bytes) { memory_budget = bytes; }
+
+    /**
+     * @brief Set the number of threads of subsetDynamicProgramming and reducedSolve.
+     * @param count The number of threads (0, the default, means all available).
+     */
+    void setThreadCount(unsigned count) { thread_count = count; }
+
+    /**
+     * @brief Get the schedule found by the last parallel machine algorithm.
+     * @return The machine and start time of every item, by position in the list.
+     */
+    const MachineSchedule &getMachineSchedule() const { return machine_schedule; }
+
     /**
      * @brief Calculate the total work time for the list of items.
      * @return The total work time.
      */
     int workTime(const bool count_idle_time);
 
+    /**
+     * @brief Analyse the current order of the list.
+     * @param finish_times Receives the finish time of every item (see analyseCriticalPath).
+     * @return The total time, the critical item, its block and the interference item
+     * (isOptimal also checks the occurrence times, so it holds for any order).
+     */
+    CriticalPath criticalPath(std::vector<int> &finish_times) const {
+        return analyseCriticalPath(main_list, finish_times);
+    }
+
     /**
      * @brief Create a new file or clear an existing one.
      * @param file_name The name of the file to create or clear.
@@ -65,21 +198,31 @@ public:
 
     /**
      * @brief Save the best permutation result to a file.
+     *
+     * The file is opened (for appending) on the first call and kept open
+     * until a different file is named or the problem is destroyed. Results
+     * go through the buffer of the file, which is flushed only then.
+     *
      * @param best_order The best permutation order of items.
      * @param best_time The total time for the best permutation.
      * @param result_file The name of the file to save results to.
      */
-    void savePermResult(const std::vector<Item> best_order, const int best_time, std::string result_file);
+    void savePermResult(const std::vector<Item> &best_order, int best_time, const std::string &result_file);
 
     /**
      * @brief Display the result.
      * @param order The order of items.
      * @param time The total time.
      */
-    void displayResult(const std::vector<Item> order, const int time);
+    void displayResult(const std::vector<Item> &order, const int time);
 
     /**
      * @brief Perform a permutation sort on the list of items.
+     *
+     * Lists of at most TINY_SOLVER_LIMIT items sorted by ID are handed to
+     * solveTinyInstance, which returns the same order. Every other visited
+     * permutation is a node for the solve control; when stopped, the better
+     * of the best permutation so far and the Schrage order is reported.
      */
     void permutationSort();
 
@@ -113,6 +256,11 @@ public:
 
     /**
      * @brief Perform Schrage Algorithm with expropriation.
+     *
+     * Whenever an item occurs with a longer idle time than the working one,
+     * it interrupts it. The reported order lists the parts of the items (an
+     * item may appear several times) and the total time is optimal when
+     * interrupting is allowed, so it is a lower bound for all other orders.
      */
     void schrageAlgorithmWithExpropriation();
 
@@ -121,11 +269,49 @@ public:
      */
     void bisoraAlgorithm();
 
+    /**
+     * @brief Perform Schrage Algorithm on identical parallel machines.
+     *
+     * The result order is the order in which items are started; see
+     * getMachineSchedule for their machines. The list itself is not changed.
+     *
+     * @param machine_count Number of machines.
+     */
+    void parallelSchrageAlgorithm(int machine_count);
+
+    /**
+     * @brief Perform dynamic programming over subsets of items (exact).
+     *
+     * Lists longer than SUBSET_SOLVER_LIMIT, or whose tables
+     * (SubsetSolver::memoryRequired) would not fit in the memory budget,
+     * are refused without allocating them; the result (also passed to the
+     * result sink) then has time -1, no order and is not complete.
+     */
+    void subsetDynamicProgramming();
+
+    /**
+     * @brief Split the list into independent blocks, solve them separately and join the orders.
+     *
+     * See InstanceReduction; small blocks are solved exactly, large ones by
+     * Schrage. Prints whether the joined order is proven optimal.
+     */
+    void reducedSolve();
+
     /**
      * @brief Measure time for a given function.
      * @param callback The function to measure time for.
      */
     void timeMeasure(std::function<void()> callback);
+
+    /**
+     * @brief Get the scratch memory of the calling thread.
+     *
+     * Every algorithm borrows it with a WorkspaceLease for its whole run, so
+     * an algorithm must not call another one of this thread while it runs.
+     *
+     * @return The workspace shared by all algorithms run on this thread.
+     */
+    static Workspace<Item> &workspace();
 };
 
 #ifdef ENABLE_DOCTEST_IN_LIBRARY
@@ -177,9 +363,21 @@ TEST_CASE("Problem class tests") {
         int best_time = 10;
         const char *result_file = "../data/test_result.txt";
 
-        // Call the function
-        Problem<Item<int>> problem;
-        problem.savePermResult(best_order, best_time, result_file);
+        // Call the function twice; the file stays open until the problem is destroyed
+        {
+            Problem<Item<int>> problem;
+            problem.savePermResult(best_order, best_time, result_file);
+            problem.savePermResult(best_order, best_time, result_file);
+
+            // Naming another file flushes the first one.
+            const char *other_file = "../data/test_result_other.txt";
+            problem.savePermResult(best_order, best_time, other_file);
+            std::ifstream flushed(result_file);
+            std::string flushed_text((std::istreambuf_iterator<char>(flushed)), std::istreambuf_iterator<char>());
+            CHECK(flushed_text == "1 2 3   Czas: 10\n1 2 3   Czas: 10\n");
+            problem.savePermResult(best_order, best_time, result_file);
+            std::remove(other_file);
+        }
 
         std::ifstream input_file(result_file);
         std::string line;
@@ -188,9 +386,12 @@ TEST_CASE("Problem class tests") {
 
         // Read the last line in the file
         std::string last_line;
+        int line_count = 0;
         while (std::getline(input_file, line)) {
             last_line = line;
+            line_count++;
         }
+        CHECK(line_count == 3);
 
         // Check if the last line contains expected content
 //        std::cout << last_line << std::endl;
@@ -261,4 +462,143 @@ TEST_CASE("idleTimeSort") {
     }
 }
 
+TEST_CASE("Critical path") {
+    Problem<Item<int>> problem;
+    CHECK_NOTHROW(problem.loadFromFile("../data/test_data.txt"));
+    std::vector<int> finish_times;
+
+    CriticalPath path = problem.criticalPath(finish_times);
+    CHECK(path.time == problem.workTime(true));
+    CHECK(finish_times.size() == problem.getSize());
+    CHECK(finish_times[path.critical] + problem.getItem(path.critical).getIdleTime() == path.time);
+}
+
+TEST_CASE("Stopping long-running algorithms") {
+    Problem<Item<int>> problem;
+    CHECK_NOTHROW(problem.loadFromFile("../data/test_4.txt"));
+    problem.setVerbose(false);
+    SolveControl control;
+    control.setNodeLimit(100000);
+    problem.setSolveControl(&control);
+
+    problem.permutationSort();
+    CHECK_FALSE(problem.getResult().complete);
+    int time = problem.getResultTime();
+    std::vector<int> order = problem.getResultOrder();
+    CHECK(time > 0);
+    CHECK(problem.getItem(0).getId() == 1);
+
+    // The node limit makes the result reproducible.
+    problem.permutationSort();
+    CHECK(problem.getResultTime() == time);
+    CHECK(problem.getResultOrder() == order);
+
+    // A stop leaves the schedule of the parallel machine algorithm alone.
+    problem.parallelSchrageAlgorithm(2);
+    MachineSchedule schedule = problem.getMachineSchedule();
+    problem.permutationSort();
+    CHECK(problem.getMachineSchedule().order == schedule.order);
+
+    control.setNodeLimit(1);
+    problem.reducedSolve();
+    CHECK_FALSE(problem.getResult().complete);
+    CHECK(problem.getResultOrder().size() == problem.getSize());
+}
+
+TEST_CASE("Memory budget of the subset DP") {
+    Problem<Item<int>> problem;
+    CHECK_NOTHROW(problem.loadFromFile("../data/test_data.txt"));
+    problem.setVerbose(false);
+
+    struct RecordingSink : ResultSink {
+        std::vector<ScheduleResult> results;
+        void write(const ScheduleResult &result) override { results.push_back(result); }
+        void flush() override {}
+    } sink;
+    problem.setResultSink(&sink);
+
+    problem.setMemoryBudget(SubsetSolver<Item<int>>::memoryRequired(problem.getSize()) - 1);
+    problem.subsetDynamicProgramming();
+    CHECK(problem.getResultTime() == -1);
+    CHECK_FALSE(problem.getResult().complete);
+    REQUIRE(sink.results.size() == 1);
+    CHECK(sink.results[0].algorithm == "dp");
+    CHECK(sink.results[0].time == -1);
+    CHECK_FALSE(sink.results[0].complete);
+    problem.setResultSink(nullptr);
+
+    problem.setMemoryBudget(SUBSET_SOLVER_MEMORY_BUDGET);
+    problem.subsetDynamicProgramming();
+    CHECK(problem.getResultTime() == 32);
+}
+
+TEST_CASE("Job layouts give the same results") {
+    // Runs every algorithm on the instance stored in a given layout.
+    auto solveAll = [](auto problem) {
+        std::vector<std::pair<int, std::vector<int>>> results;
+        problem.setVerbose(false);
+        CHECK_NOTHROW(problem.loadFromFile("../data/test_2.txt"));
+        for (auto algorithm: {&decltype(problem)::schrageAlgorithmV1, &decltype(problem)::schrageAlgorithmV2,
+                              &decltype(problem)::schrageAlgorithmWithExpropriation,
+                              &decltype(problem)::bisoraAlgorithm, &decltype(problem)::subsetDynamicProgramming,
+                              &decltype(problem)::reducedSolve}) {
+            (problem.*algorithm)();
+            results.emplace_back(problem.getResultTime(), problem.getResultOrder());
+        }
+        return results;
+    };
+
+    auto expected = solveAll(Problem<Item<int>>());
+    CHECK(solveAll(Problem<Item<short>>()) == expected);
+    CHECK(solveAll(Problem<SoaJob>()) == expected);
+
+    // The rows of the items the algorithms change are removed after every run.
+    Problem<SoaJob> soa_problem;
+    soa_problem.setVerbose(false);
+    soa_problem.loadFromFile("../data/test_2.txt");
+    std::size_t rows = SoaJobStore::local().size();
+    for (int run = 0; run < 3; run++) {
+        soa_problem.schrageAlgorithmV2();
+        soa_problem.schrageAlgorithmWithExpropriation();
+        soa_problem.reducedSolve();
+        CHECK(SoaJobStore::local().size() == rows);
+    }
+    CHECK(soa_problem.getResultTime() == expected.back().first);
+    SoaJobStore::local().truncate();
+
+    std::istringstream too_large("1\n40000 1 1\n");
+    std::string error;
+    Problem<Item<short>> compact;
+    CHECK_FALSE(compact.loadFromStream(too_large, error));
+}
+
+TEST_CASE("Result sink") {
+    struct RecordingSink : ResultSink {
+        std::vector<ScheduleResult> results;
+        void write(const ScheduleResult &result) override { results.push_back(result); }
+        void flush() override {}
+    };
+
+    Problem<Item<int>> problem;
+    CHECK_NOTHROW(problem.loadFromFile("../data/test_data.txt"));
+    problem.setVerbose(false);
+    RecordingSink sink;
+
+    SUBCASE("Algorithms pass their results to the sink") {
+        problem.setResultSink(&sink);
+        problem.bisoraAlgorithm();
+        REQUIRE(sink.results.size() == 1);
+        CHECK(sink.results[0].algorithm == "bisora");
+        CHECK(sink.results[0].time == problem.getResultTime());
+        CHECK(sink.results[0].order == problem.getResultOrder());
+    }
+
+    SUBCASE("Every permutation is logged") {
+        problem.setPermutationLog(&sink);
+        problem.permutationSort();
+        CHECK(sink.results.size() == 720);
+        CHECK(problem.getResultTime() == 32);
+    }
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,261 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief The result of one algorithm run.
+ */
+struct ScheduleResult {
+    std::string algorithm; ///< Short name of the algorithm (e.g. "bisora").
+    int time = -1; ///< Total time of the order.
+    std::vector<int> order; ///< IDs of the items in the order.
+    bool complete = true; ///< false if the algorithm was stopped and the order is only the best found.
+};
+
+/**
+ * @brief Destination of results.
+ *
+ * Writers keep one file open for their whole life and write through a large
+ * buffer, so results are not flushed one by one.
+ */
+class ResultSink {
+public:
+    virtual ~ResultSink() = default;
+
+    /**
+     * @brief Write one result.
+     * @param result The result to write.
+     */
+    virtual void write(const ScheduleResult &result) = 0;
+
+    /**
+     * @brief Push everything written so far to the file.
+     */
+    virtual void flush() = 0;
+};
+
+/**
+ * @brief Base of the sinks writing to a file.
+ */
+class FileSink : public ResultSink {
+protected:
+    std::vector<char> buffer; /**< Buffer of the file stream. */
+    std::ofstream output_file; /**< The open file. */
+    std::string line; /**< The record being formatted, reused between writes. */
+
+public:
+    /**
+     * @brief Open the file.
+     * @param file_name The name of the file.
+     * @param append true to add to the end of the file, false to clear it.
+     * @param binary true to open the file in binary mode.
+     */
+    FileSink(const std::string &file_name, bool append, bool binary = false);
+
+    /**
+     * @brief Destructor; flushes what is still in the buffer.
+     */
+    ~FileSink() override;
+
+    void flush() override;
+};
+
+/**
+ * @brief Writes "1 2 3   Czas: 10" lines (the format of Problem::savePermResult).
+ */
+class TextSink : public FileSink {
+public:
+    /**
+     * @brief Open the file.
+     * @param file_name The name of the file.
+     * @param append true to add to the end of the file, false to clear it.
+     */
+    TextSink(const std::string &file_name, bool append = false);
+
+    void write(const ScheduleResult &result) override;
+};
+
+/**
+ * @brief Writes "algorithm,time,order" lines with IDs separated by spaces, after a header line.
+ */
+class CsvSink : public FileSink {
+public:
+    /**
+     * @brief Open (and clear) the file.
+     * @param file_name The name of the file.
+     */
+    explicit CsvSink(const std::string &file_name);
+
+    void write(const ScheduleResult &result) override;
+};
+
+/**
+ * @brief Writes one JSON object per line: {"algorithm":"...","time":..,"order":[..]}.
+ *
+ * Quotes, backslashes and control characters in the algorithm name are escaped.
+ */
+class JsonLinesSink : public FileSink {
+public:
+    /**
+     * @brief Open (and clear) the file.
+     * @param file_name The name of the file.
+     */
+    explicit JsonLinesSink(const std::string &file_name);
+
+    void write(const ScheduleResult &result) override;
+};
+
+/**
+ * @brief Writes records of native-endian integers.
+ *
+ * Each record: uint16 name length, the name, int32 time, uint32 item count,
+ * then int32 IDs.
+ */
+class BinarySink : public FileSink {
+public:
+    /**
+     * @brief Open (and clear) the file.
+     * @param file_name The name of the file.
+     */
+    explicit BinarySink(const std::string &file_name);
+
+    void write(const ScheduleResult &result) override;
+};
+
+/**
+ * @brief Hands results to another sink on a background thread.
+ *
+ * write() only copies the result into a pending batch; the thread swaps the
+ * batch out and writes it, so formatting and file I/O leave the solving thread.
+ * The batch holds at most a given number of results: when the file cannot
+ * keep up, write() waits for the thread instead of queueing without limit.
+ */
+class AsyncSink : public ResultSink {
+private:
+    std::unique_ptr<ResultSink> target; /**< The sink doing the writing. */
+    std::vector<ScheduleResult> pending; /**< Results waiting for the thread. */
+    std::size_t capacity; /**< Largest number of results waiting for the thread. */
+    std::mutex mutex; /**< Guards pending and the flags. */
+    std::condition_variable changed; /**< Signals new results, finished batches and stopping. */
+    bool writing; /**< Whether the thread holds a batch. */
+    bool stopping; /**< Whether the thread should finish. */
+    std::thread writer; /**< The background thread. */
+
+    /**
+     * @brief Main loop of the background thread.
+     */
+    void work();
+
+public:
+    /**
+     * @brief Constructor starting the background thread.
+     * @param target_s The sink to write to.
+     * @param capacity_s Largest number of results waiting for the thread (at least 1).
+     */
+    explicit AsyncSink(std::unique_ptr<ResultSink> target_s, std::size_t capacity_s = 4096);
+
+    /**
+     * @brief Destructor; writes the pending results and stops the thread.
+     */
+    ~AsyncSink() override;
+
+    void write(const ScheduleResult &result) override;
+
+    /**
+     * @brief Wait until every result is written, then flush the target.
+     */
+    void flush() override;
+};
+
+#ifdef ENABLE_DOCTEST_IN_LIBRARY
+
+#include "doctest/doctest.h"
+
+#include <cstdio>
+
+TEST_CASE("Result sinks") {
+    ScheduleResult result;
+    result.algorithm = "bisora";
+    result.time = 32;
+    result.order = {1, 5, 3};
+    const char *file_name = "sink_test.txt";
+
+    auto readAll = [&]() {
+        std::ifstream input_file(file_name, std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(input_file)), std::istreambuf_iterator<char>());
+    };
+
+    SUBCASE("Text") {
+        {
+            TextSink sink(file_name);
+            sink.write(result);
+            sink.write(result);
+        }
+        CHECK(readAll() == "1 5 3   Czas: 32\n1 5 3   Czas: 32\n");
+    }
+
+    SUBCASE("CSV") {
+        {
+            CsvSink sink(file_name);
+            sink.write(result);
+        }
+        CHECK(readAll() == "algorithm,time,order\nbisora,32,1 5 3\n");
+    }
+
+    SUBCASE("JSON Lines") {
+        {
+            JsonLinesSink sink(file_name);
+            sink.write(result);
+        }
+        CHECK(readAll() == "{\"algorithm\":\"bisora\",\"time\":32,\"order\":[1,5,3]}\n");
+    }
+
+    SUBCASE("JSON Lines escaping") {
+        result.algorithm = "a\"b\\c\n\x01";
+        {
+            JsonLinesSink sink(file_name);
+            sink.write(result);
+        }
+        CHECK(readAll() == "{\"algorithm\":\"a\\\"b\\\\c\\n\\u0001\",\"time\":32,\"order\":[1,5,3]}\n");
+    }
+
+    SUBCASE("Binary") {
+        {
+            BinarySink sink(file_name);
+            sink.write(result);
+        }
+        CHECK(readAll().size() == 2 + 6 + 4 + 4 + 3 * 4);
+    }
+
+    SUBCASE("Background writer") {
+        {
+            AsyncSink sink(std::unique_ptr<ResultSink>(new TextSink(file_name)));
+            for (int i = 0; i < 1000; i++) {
+                sink.write(result);
+            }
+            sink.flush();
+            CHECK(readAll().size() == 1000 * std::string("1 5 3   Czas: 32\n").size());
+        }
+    }
+
+    SUBCASE("Background writer with a small batch") {
+        {
+            AsyncSink sink(std::unique_ptr<ResultSink>(new TextSink(file_name)), 2);
+            for (int i = 0; i < 1000; i++) {
+                sink.write(result);
+            }
+        }
+        CHECK(readAll().size() == 1000 * std::string("1 5 3   Czas: 32\n").size());
+    }
+
+    std::remove(file_name);
+}
+
+#endif
@@ -0,0 +1,240 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+/**
+ * @brief Progress of a running algorithm.
+ */
+struct SolveProgress {
+    int incumbent = -1; ///< Total time of the best order found so far (-1 if none yet).
+    int lower_bound = 0; ///< Best known lower bound of the total time.
+    uint64_t nodes = 0; ///< Nodes visited so far (permutations, subsets, ...).
+    double seconds = 0; ///< Time since the algorithm started.
+    double nodes_per_second = 0; ///< Average speed of the search.
+};
+
+/**
+ * @brief Flag another thread sets to stop an algorithm.
+ */
+class CancellationToken {
+private:
+    std::atomic<bool> cancelled; /**< Whether the algorithm should stop. */
+
+public:
+    CancellationToken() : cancelled(false) {}
+
+    /**
+     * @brief Ask the algorithm to stop (safe to call from any thread).
+     */
+    void cancel() { cancelled.store(true, std::memory_order_relaxed); }
+
+    /**
+     * @brief Allow the next run to go on.
+     */
+    void reset() { cancelled.store(false, std::memory_order_relaxed); }
+
+    /**
+     * @brief Check whether stopping was asked for.
+     * @return true If cancel was called since the last reset.
+     */
+    bool isCancelled() const { return cancelled.load(std::memory_order_relaxed); }
+};
+
+/**
+ * @brief Limits and progress reporting of a long-running algorithm.
+ *
+ * An algorithm calls begin() when it starts, shouldStop() after every node
+ * and finish() at the end; when shouldStop() returns true it ends with the
+ * best order found so far. The token and the node limit are checked on every
+ * call, the clock (deadline and progress reports) once every
+ * CLOCK_CHECK_NODES nodes.
+ *
+ * Algorithms are deterministic, so a run that ends by itself or at the node
+ * limit gives the same result every time (for the same thread count). A run
+ * stopped by the token or the deadline returns whatever was found by then.
+ */
+class SolveControl {
+public:
+    using Clock = std::chrono::steady_clock; ///< Clock of the deadline.
+    using ProgressCallback = std::function<void(const SolveProgress &)>; ///< Receives progress reports.
+
+    static constexpr uint64_t CLOCK_CHECK_NODES = 4096; ///< Nodes between reads of the clock.
+
+private:
+    const CancellationToken *token; /**< Token to watch (may be null). */
+    Clock::time_point deadline; /**< Moment to stop at (max if none). */
+    uint64_t node_limit; /**< Nodes to stop after (max if none). */
+    ProgressCallback progress; /**< Receives progress reports (may be empty). */
+    Clock::duration report_interval; /**< Time between progress reports. */
+
+    Clock::time_point start; /**< Start of the current run. */
+    Clock::time_point next_report; /**< Moment of the next progress report. */
+    uint64_t next_check; /**< Node count at which the clock is read next. */
+    bool stopped; /**< Whether the current run was stopped. */
+
+    /**
+     * @brief Check the clock and the node limit and report progress if due.
+     * @param nodes Nodes visited so far.
+     * @param incumbent Total time of the best order so far.
+     * @param lower_bound Best known lower bound.
+     * @return true If the algorithm should stop.
+     */
+    bool check(uint64_t nodes, int incumbent, int lower_bound);
+
+    /**
+     * @brief Call the progress callback.
+     * @param now The current moment.
+     * @param nodes Nodes visited so far.
+     * @param incumbent Total time of the best order so far.
+     * @param lower_bound Best known lower bound.
+     */
+    void report(Clock::time_point now, uint64_t nodes, int incumbent, int lower_bound);
+
+public:
+    /**
+     * @brief Constructor without any limits.
+     */
+    SolveControl();
+
+    /**
+     * @brief Watch a cancellation token.
+     * @param token_s The token (kept by the caller), or nullptr.
+     */
+    void setToken(const CancellationToken *token_s) { token = token_s; }
+
+    /**
+     * @brief Stop at a moment.
+     * @param deadline_s The moment (Clock::time_point::max() for none).
+     */
+    void setDeadline(Clock::time_point deadline_s) { deadline = deadline_s; }
+
+    /**
+     * @brief Stop after a number of nodes; gives reproducible results.
+     * @param node_limit_s The number of nodes (UINT64_MAX for none).
+     */
+    void setNodeLimit(uint64_t node_limit_s) { node_limit = node_limit_s; }
+
+    /**
+     * @brief Receive progress reports.
+     * @param progress_s The callback (called on the solving thread).
+     * @param interval Time between reports.
+     */
+    void setProgressCallback(ProgressCallback progress_s,
+                             std::chrono::milliseconds interval = std::chrono::milliseconds(100));
+
+    /**
+     * @brief Start a run.
+     */
+    void begin();
+
+    /**
+     * @brief Check whether the algorithm should stop.
+     * @param nodes Nodes visited so far in this run.
+     * @param incumbent Total time of the best order so far (-1 if none).
+     * @param lower_bound Best known lower bound.
+     * @return true If the algorithm should stop now.
+     */
+    bool shouldStop(uint64_t nodes, int incumbent, int lower_bound) {
+        if (stopped) {
+            return true;
+        }
+        if (nodes < next_check && (token == nullptr || !token->isCancelled())) {
+            return false;
+        }
+        return check(nodes, incumbent, lower_bound);
+    }
+
+    /**
+     * @brief End a run with a last progress report.
+     * @param nodes Nodes visited in this run.
+     * @param incumbent Total time of the returned order.
+     * @param lower_bound Best known lower bound.
+     */
+    void finish(uint64_t nodes, int incumbent, int lower_bound);
+
+    /**
+     * @brief Check whether the last run was stopped before it ended by itself.
+     * @return true If it was stopped.
+     */
+    bool wasStopped() const { return stopped; }
+
+    /**
+     * @brief Make a control for a part of the run solved on another thread.
+     *
+     * The part watches the same token and deadline and has the same node
+     * limit for its own nodes, but reports no progress, so every thread can
+     * use its own part while this control stays on the calling thread.
+     *
+     * @return The control of the part.
+     */
+    SolveControl part() const;
+
+    /**
+     * @brief Take over the outcome of a part once its thread is done with it.
+     * @param part_s The part (see part()).
+     */
+    void join(const SolveControl &part_s) { stopped = stopped || part_s.stopped; }
+};
+
+#ifdef ENABLE_DOCTEST_IN_LIBRARY
+
+#include "doctest/doctest.h"
+
+TEST_CASE("SolveControl") {
+    SolveControl control;
+    int reports = 0;
+    SolveProgress last;
+    control.setProgressCallback([&](const SolveProgress &progress) {
+        reports++;
+        last = progress;
+    });
+
+    SUBCASE("Node limit") {
+        control.setNodeLimit(10000);
+        control.begin();
+        uint64_t nodes = 0;
+        while (!control.shouldStop(nodes, 50, 40)) {
+            nodes++;
+        }
+        CHECK(nodes == 10000);
+        CHECK(control.wasStopped());
+        control.finish(nodes, 50, 40);
+        CHECK(reports >= 1);
+        CHECK(last.nodes == 10000);
+        CHECK(last.incumbent == 50);
+    }
+
+    SUBCASE("Token and deadline") {
+        CancellationToken token;
+        control.setToken(&token);
+        control.begin();
+        CHECK_FALSE(control.shouldStop(1, -1, 0));
+        token.cancel();
+        CHECK(control.shouldStop(2, -1, 0));
+
+        token.reset();
+        control.setDeadline(SolveControl::Clock::now());
+        control.begin();
+        CHECK(control.shouldStop(SolveControl::CLOCK_CHECK_NODES, -1, 0));
+    }
+
+    SUBCASE("Parts") {
+        control.setNodeLimit(100);
+        control.begin();
+        SolveControl part = control.part();
+        part.begin();
+        CHECK_FALSE(part.shouldStop(99, -1, 0));
+        control.join(part);
+        CHECK_FALSE(control.wasStopped());
+        CHECK(part.shouldStop(100, -1, 0));
+        part.finish(100, -1, 0);
+        control.join(part);
+        CHECK(control.wasStopped());
+        CHECK(reports == 0);
+    }
+}
+
+#endif
@@ -0,0 +1,260 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief The largest instance the service solves with "perm".
+ *
+ * Up to 10! orders, so one request cannot hold a worker for long even
+ * without a deadline.
+ */
+constexpr std::size_t SERVICE_PERMUTATION_LIMIT = 10;
+
+/**
+ * @brief The largest instance the service accepts with any algorithm.
+ */
+constexpr std::size_t SERVICE_ITEM_LIMIT = 100000;
+
+/**
+ * @brief Default number of requests the service queue holds.
+ */
+constexpr std::size_t SERVICE_QUEUE_CAPACITY = 64;
+
+/**
+ * @brief A single instance sent to the solve service.
+ */
+struct SolveRequest {
+    uint64_t id = 0; ///< Identifier chosen by the client, echoed in the response.
+    std::string algorithm; ///< Name of the algorithm to run.
+    std::string instance; ///< The instance, in the format of the data files.
+    std::chrono::steady_clock::time_point deadline =
+        std::chrono::steady_clock::time_point::max(); ///< Moment after which the result is not wanted.
+};
+
+/**
+ * @brief Outcome of a request.
+ */
+enum class SolveStatus {
+    Solved, ///< The algorithm produced an order.
+    Partial, ///< The deadline stopped the algorithm; the order is the best it found.
+    Expired, ///< The deadline passed before the result was ready.
+    Failed ///< The request could not be solved (bad data, unknown algorithm, ...).
+};
+
+/**
+ * @brief The answer to a SolveRequest.
+ */
+struct SolveResponse {
+    uint64_t id = 0; ///< Identifier of the request.
+    SolveStatus status = SolveStatus::Failed; ///< Outcome of the request.
+    int time = -1; ///< Total time of the order (when solved or partial).
+    std::vector<int> order; ///< IDs of the items in the order (when solved or partial).
+    std::string error; ///< Description of the failure (when failed).
+};
+
+/**
+ * @brief Parse the header line of a request: "SOLVE <id> <algorithm> <deadline in ms>".
+ *
+ * A deadline of 0 means no deadline. The instance itself follows the header
+ * (item count line, then one line per item) and is not read here. The
+ * algorithm name is checked only when the request is solved.
+ *
+ * @param line The header line.
+ * @param request Receives the ID, algorithm and deadline.
+ * @param error Receives the description of the problem if parsing fails.
+ * @return true If the header is valid.
+ */
+bool parseRequestHeader(const std::string &line, SolveRequest &request, std::string &error);
+
+/**
+ * @brief Format a response as one line (without the line break).
+ *
+ * "RESULT <id> <time> <ids...>", "PARTIAL <id> <time> <ids...>", "EXPIRED <id>" or
+ * "ERROR <id> <description>".
+ *
+ * @param response The response to format.
+ * @return The formatted line.
+ */
+std::string formatResponse(const SolveResponse &response);
+
+/**
+ * @brief A pool of workers solving queued requests.
+ *
+ * Requests are answered through a callback, in the order they finish, so a
+ * client may send many requests without waiting for answers. Each worker
+ * keeps its thread (and so its workspace) for the lifetime of the service.
+ * The queue holds a bounded number of requests: submit waits for room, so
+ * the readers feeding it stop reading while it is full. The hardware threads
+ * are split between the workers, so the algorithms using several threads do
+ * not run more of them than there are cores.
+ */
+class SolveService {
+public:
+    using Callback = std::function<void(const SolveResponse &)>; ///< Receives the response.
+
+private:
+    std::mutex mutex; ///< Guards the queue and the stopping flag.
+    std::condition_variable ready; ///< Signalled when a request is queued or the service stops.
+    std::condition_variable room; ///< Signalled when a request leaves the queue.
+    std::deque<std::pair<SolveRequest, Callback>> queue; ///< Requests waiting for a worker.
+    std::size_t capacity; ///< Largest number of requests in the queue.
+    std::vector<std::thread> workers; ///< The worker threads.
+    unsigned solver_threads; ///< Threads each request may use.
+    bool stopping; ///< Whether the workers should finish.
+
+    /**
+     * @brief Main loop of a worker.
+     */
+    void work();
+
+public:
+    /**
+     * @brief Constructor starting the workers.
+     * @param worker_count Number of worker threads (0 means all available).
+     * @param capacity_s Largest number of requests waiting in the queue (at least 1).
+     */
+    explicit SolveService(unsigned worker_count = 0, std::size_t capacity_s = SERVICE_QUEUE_CAPACITY);
+
+    /**
+     * @brief Destructor; answers the queued requests and stops the workers.
+     */
+    ~SolveService();
+
+    SolveService(const SolveService &) = delete;
+    SolveService &operator=(const SolveService &) = delete;
+
+    /**
+     * @brief Queue a request, waiting while the queue is full.
+     * @param request The request to solve.
+     * @param callback Called from a worker thread with the response.
+     */
+    void submit(SolveRequest request, Callback callback);
+
+    /**
+     * @brief Get the number of threads each request may use.
+     * @return The hardware threads divided between the workers (at least 1).
+     */
+    unsigned getSolverThreads() const { return solver_threads; }
+
+    /**
+     * @brief Solve a request on the calling thread.
+     *
+     * The deadline also stops the long-running algorithms, which then
+     * answer with the best order found so far. Instances of more than
+     * SERVICE_ITEM_LIMIT items fail, and "perm" fails for instances of
+     * more than SERVICE_PERMUTATION_LIMIT items.
+     *
+     * @param request The request to solve.
+     * @param thread_count Threads "dp" and "reduced" may use.
+     * @return The response.
+     */
+    static SolveResponse solve(const SolveRequest &request, unsigned thread_count = 1);
+
+    /**
+     * @brief Get the names of the algorithms the service can run.
+     * @return The names, as accepted in SolveRequest::algorithm.
+     */
+    static std::vector<std::string> algorithms();
+};
+
+#ifdef ENABLE_DOCTEST_IN_LIBRARY
+
+#include "doctest/doctest.h"
+
+#include <future>
+
+TEST_CASE("SolveService") {
+    SolveRequest request;
+    request.id = 7;
+    request.algorithm = "schrage";
+    request.instance = "6\n1 5 9\n4 5 4\n1 4 6\n7 3 3\n3 6 8\n4 7 1\n";
+
+    SUBCASE("Request header") {
+        SolveRequest parsed;
+        std::string error;
+        CHECK(parseRequestHeader("SOLVE 12 bisora 0", parsed, error));
+        CHECK(parsed.id == 12);
+        CHECK(parsed.algorithm == "bisora");
+        CHECK(parsed.deadline == std::chrono::steady_clock::time_point::max());
+        CHECK_FALSE(parseRequestHeader("SOLVE 12 bisora", parsed, error));
+        CHECK_FALSE(parseRequestHeader("STOP 12 bisora 0", parsed, error));
+    }
+
+    SUBCASE("Queued requests are answered") {
+        SolveService service(2);
+        CHECK(service.getSolverThreads() >= 1);
+        CHECK(service.getSolverThreads() <= std::max(1u, std::thread::hardware_concurrency()));
+        std::promise<SolveResponse> answer;
+        service.submit(request, [&](const SolveResponse &response) { answer.set_value(response); });
+
+        SolveResponse response = answer.get_future().get();
+        CHECK(response.status == SolveStatus::Solved);
+        CHECK(response.time == 32);
+        CHECK(formatResponse(response) == "RESULT 7 32 1 5 3 2 4 6");
+    }
+
+    SUBCASE("A full queue makes submit wait") {
+        std::mutex mutex;
+        std::condition_variable answered;
+        int answers = 0;
+        SolveService service(1, 1);
+        for (int i = 0; i < 20; i++) {
+            service.submit(request, [&](const SolveResponse &) {
+                std::lock_guard<std::mutex> lock(mutex);
+                answers++;
+                answered.notify_one();
+            });
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        answered.wait(lock, [&]() { return answers == 20; });
+        CHECK(answers == 20);
+    }
+
+    SUBCASE("Expired and invalid requests") {
+        request.deadline = std::chrono::steady_clock::now() - std::chrono::milliseconds(1);
+        CHECK(SolveService::solve(request).status == SolveStatus::Expired);
+
+        request.deadline = std::chrono::steady_clock::time_point::max();
+        request.algorithm = "unknown";
+        CHECK(SolveService::solve(request).status == SolveStatus::Failed);
+
+        request.algorithm = "schrage";
+        request.instance = "2\n1 2 3\n";
+        CHECK(SolveService::solve(request).status == SolveStatus::Failed);
+
+        request.instance = std::to_string(SERVICE_ITEM_LIMIT + 1) + "\n";
+        for (std::size_t i = 0; i <= SERVICE_ITEM_LIMIT; i++) {
+            request.instance += "1 1 1\n";
+        }
+        SolveResponse response = SolveService::solve(request);
+        CHECK(response.status == SolveStatus::Failed);
+        CHECK(response.error.find("Zbyt wiele zadań") != std::string::npos);
+    }
+
+    SUBCASE("Large searches are refused or stopped by the deadline") {
+        request.algorithm = "perm";
+        request.instance = "22\n";
+        for (int i = 0; i < 22; i++) {
+            request.instance += std::to_string(i * 3) + " " + std::to_string(5 + i % 4) + " " + std::to_string(30 - i) + "\n";
+        }
+        CHECK(SolveService::solve(request).status == SolveStatus::Failed);
+
+        request.algorithm = "dp";
+        request.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(20);
+        SolveResponse response = SolveService::solve(request);
+        CHECK(response.status == SolveStatus::Partial);
+        CHECK(response.order.size() == 22);
+    }
+}
+
+#endif
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "solve_control.h"
+
+/**
+ * @brief The largest number of items handled by SubsetSolver.
+ */
+constexpr std::size_t SUBSET_SOLVER_LIMIT = 25;
+
+/**
+ * @brief Default memory a SubsetSolver may take (see SubsetSolver::memoryRequired).
+ */
+constexpr std::size_t SUBSET_SOLVER_MEMORY_BUDGET = std::size_t(64) << 20;
+
+class LayerWorkers;
+
+/**
+ * @brief Exact solver using dynamic programming over subsets of items.
+ *
+ * For a candidate total time T every item gets the deadline T - idle time,
+ * and the table holds, for each subset, the earliest moment the subset can
+ * be finished with all its items on time (or nothing if it cannot). The
+ * smallest T for which the whole set can be finished is found by binary
+ * search between a lower bound and the Schrage time.
+ *
+ * Subsets are processed layer by layer (by number of items), and only two
+ * layers are kept, indexed by their colexicographic rank. Each layer is split
+ * between threads, which are started once per solve and reused for every
+ * layer of every check. The threads read only a copy of the times made by
+ * the constructor, so items that are read through the calling thread (like
+ * SoaJob) can be used too. The only full-size table is one byte per subset
+ * naming its last item, used to rebuild the order.
+ *
+ * @tparam Item The type of items in the problem.
+ */
+template<class Item>
+class SubsetSolver {
+private:
+    /**
+     * @brief Times of an item as plain ints.
+     */
+    struct Times {
+        int occur_time; ///< Occurrence time.
+        int work_time; ///< Work time.
+        int idle_time; ///< Idle time.
+    };
+
+    std::vector<Item> items; /**< The items to schedule. */
+    std::vector<Times> times; /**< Times of the items, the only part of them the threads read. */
+    unsigned thread_count; /**< Number of threads filling a layer. */
+    std::vector<std::vector<uint64_t>> binomial; /**< binomial[n][k] for ranking subsets. */
+    std::vector<int> previous_layer; /**< Finish times of the previous layer. */
+    std::vector<int> current_layer; /**< Finish times of the layer being filled. */
+    std::vector<uint8_t> last_item; /**< Last item of the best order of every subset. */
+    SolveControl *control; /**< Limits of the current solve (may be null). */
+    uint64_t nodes; /**< Subsets filled in the current solve. */
+    int lower; /**< Current lower bound of the total time. */
+    int upper; /**< Total time of the best order found so far. */
+
+    /**
+     * @brief Fill the part of a layer between two ranks.
+     * @param size The number of items in the subsets of the layer.
+     * @param first The rank of the first subset.
+     * @param last One past the rank of the last subset.
+     * @param limit The candidate total time.
+     * @return true If any subset of the range can be finished on time.
+     */
+    bool fillRange(std::size_t size, uint64_t first, uint64_t last, int limit);
+
+    /**
+     * @brief Check whether all items can be finished within the given total time.
+     * @param limit The candidate total time.
+     * @param workers The threads sharing the layers.
+     * @return true If such an order exists (the last_item table then describes it);
+     * false also when the control stops the check.
+     */
+    bool feasible(int limit, LayerWorkers &workers);
+
+    /**
+     * @brief Rebuild the order described by the last_item table.
+     * @param order Receives the items in that order.
+     * @return The total time of the order.
+     */
+    int readOrder(std::vector<Item> &order) const;
+
+public:
+    /**
+     * @brief Constructor taking the list to solve.
+     * @param items_s The items to schedule (at most SUBSET_SOLVER_LIMIT, checked by an assertion).
+     * @param thread_count_s Number of threads to use (0 means all available).
+     */
+    SubsetSolver(const std::vector<Item> &items_s, unsigned thread_count_s = 0);
+
+    /**
+     * @brief Get the memory needed to solve a list of the given size.
+     * @param size The number of items.
+     * @return The number of bytes of all tables.
+     */
+    static std::size_t memoryRequired(std::size_t size);
+
+    /**
+     * @brief Find the optimal order.
+     *
+     * The search starts from the Schrage order and every successful check
+     * replaces it with a better one, so when the control stops the search,
+     * the best order found so far is returned. The control is checked
+     * before every layer; nodes are the subsets filled.
+     *
+     * @param best_order Receives the items in the optimal (or best found) order.
+     * @param control_s Limits and progress reporting (may be null).
+     * @return The total time of the returned order.
+     */
+    int solve(std::vector<Item> &best_order, SolveControl *control_s = nullptr);
+};
+
+#ifdef ENABLE_DOCTEST_IN_LIBRARY
+
+#include "doctest/doctest.h"
+#include "item.h"
+#include "job.h"
+
+TEST_CASE("SubsetSolver") {
+    std::vector<Item<int>> items = {Item<int>(1, 1, 5, 9), Item<int>(2, 4, 5, 4), Item<int>(3, 1, 4, 6),
+                                    Item<int>(4, 7, 3, 3), Item<int>(5, 3, 6, 8), Item<int>(6, 4, 7, 1)};
+
+    SUBCASE("Memory grows with one byte per subset") {
+        CHECK(SubsetSolver<Item<int>>::memoryRequired(20) > (std::size_t(1) << 20));
+        CHECK(SubsetSolver<Item<int>>::memoryRequired(20) < (std::size_t(1) << 24));
+    }
+
+    SUBCASE("Optimal time and a matching order") {
+        std::vector<Item<int>> order;
+        for (unsigned threads: {1u, 3u}) {
+            SubsetSolver<Item<int>> solver(items, threads);
+            CHECK(solver.solve(order) == 32);
+            REQUIRE(order.size() == items.size());
+
+            int time = 0, total = 0;
+            for (const Item<int> &item: order) {
+                time = std::max(time, item.getOccurTime()) + item.getWorkTime();
+                total = std::max(total, time + item.getIdleTime());
+            }
+            CHECK(total == 32);
+        }
+    }
+
+    SUBCASE("Threads kept for the whole solve give the same result") {
+        std::vector<Item<int>> larger;
+        for (int i = 0; i < 16; i++) {
+            larger.emplace_back(i + 1, (i * 7) % 23, 1 + (i * 5) % 9, (i * 11) % 17);
+        }
+        std::vector<Item<int>> order;
+        int time = SubsetSolver<Item<int>>(larger, 1).solve(order);
+        CHECK(SubsetSolver<Item<int>>(larger, 3).solve(order) == time);
+        CHECK(order.size() == larger.size());
+
+        std::vector<SoaJob> rows, row_order;
+        for (const Item<int> &item: larger) {
+            rows.emplace_back(item.getId(), item.getOccurTime(), item.getWorkTime(), item.getIdleTime());
+        }
+        CHECK(SubsetSolver<SoaJob>(rows, 3).solve(row_order) == time);
+        CHECK(row_order.size() == rows.size());
+    }
+
+    SUBCASE("Stopping returns the best order found so far") {
+        std::vector<Item<int>> order;
+        SolveControl control;
+        control.setNodeLimit(1);
+        SubsetSolver<Item<int>> solver(items, 1);
+        int time = solver.solve(order, &control);
+        CHECK(control.wasStopped());
+        CHECK(time >= 32);
+        CHECK(order.size() == items.size());
+    }
+}
+
+#endif
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief The largest number of items handled by TinySolver.
+ */
+constexpr std::size_t TINY_SOLVER_LIMIT = 12;
+
+/**
+ * @brief Exact solver for instances whose size is known at compile time.
+ *
+ * Branch and bound over permutations kept entirely in fixed-size arrays.
+ * Every depth of the search is a separate template instance, so the whole
+ * tree is unrolled by the compiler. Items are tried in their list order and
+ * only strictly better orders replace the incumbent, so the result is the
+ * lexicographically first optimal order - the same one permutationSort finds.
+ *
+ * @tparam N The number of items.
+ */
+template<std::size_t N>
+class TinySolver {
+private:
+    std::array<int, N> occur_time; /**< Occurrence times of the items. */
+    std::array<int, N> work_time; /**< Work times of the items. */
+    std::array<int, N> idle_time; /**< Idle times of the items. */
+    std::array<int, N> current_order; /**< Order on the current branch. */
+    std::array<int, N> best_order; /**< Best order found so far. */
+    int best_time; /**< Total time of the best order. */
+
+    /**
+     * @brief Extend the current branch by one item.
+     * @tparam Depth The number of items already placed.
+     * @param used Bit mask of placed items.
+     * @param time Completion time of the last placed item.
+     * @param total Largest completion time plus idle time so far.
+     */
+    template<std::size_t Depth>
+    void branch(unsigned used, int time, int total);
+
+public:
+    /**
+     * @brief Constructor taking the item attributes in list order.
+     * @param occur_time_s The occurrence times.
+     * @param work_time_s The work times.
+     * @param idle_time_s The idle times.
+     */
+    TinySolver(const std::array<int, N> &occur_time_s, const std::array<int, N> &work_time_s,
+               const std::array<int, N> &idle_time_s);
+
+    /**
+     * @brief Find the optimal order.
+     * @param order Receives the list positions of the items in the optimal order.
+     * @return The total time of the optimal order.
+     */
+    int solve(std::array<int, N> &order);
+};
+
+/**
+ * @brief Solve a list of at most TINY_SOLVER_LIMIT items with the matching TinySolver.
+ *
+ * @tparam Item The type of items in the list.
+ * @param list The items to schedule.
+ * @param best_order Receives the items in the optimal order.
+ * @return The total time of the optimal order.
+ */
+template<class Item>
+int solveTinyInstance(const std::vector<Item> &list, std::vector<Item> &best_order);
+
+#ifdef ENABLE_DOCTEST_IN_LIBRARY
+
+#include "doctest/doctest.h"
+#include "item.h"
+
+#include <algorithm>
+#include <numeric>
+
+TEST_CASE("TinySolver") {
+    std::array<int, 6> occur_time = {1, 4, 1, 7, 3, 4};
+    std::array<int, 6> work_time = {5, 5, 4, 3, 6, 7};
+    std::array<int, 6> idle_time = {9, 4, 6, 3, 8, 1};
+
+    SUBCASE("Agrees with the first optimal permutation") {
+        std::array<int, 6> permutation;
+        std::iota(permutation.begin(), permutation.end(), 0);
+        std::array<int, 6> expected_order = permutation;
+        int expected_time = -1;
+        do {
+            int time = 0, total = 0;
+            for (int i: permutation) {
+                time = std::max(time, occur_time[i]) + work_time[i];
+                total = std::max(total, time + idle_time[i]);
+            }
+            if (expected_time < 0 || total < expected_time) {
+                expected_time = total;
+                expected_order = permutation;
+            }
+        } while (std::next_permutation(permutation.begin(), permutation.end()));
+
+        std::vector<Item<int>> list, order;
+        for (std::size_t i = 0; i < occur_time.size(); i++) {
+            list.emplace_back(int(i) + 1, occur_time[i], work_time[i], idle_time[i]);
+        }
+        CHECK(solveTinyInstance(list, order) == expected_time);
+        REQUIRE(order.size() == list.size());
+        bool same = true;
+        for (std::size_t i = 0; i < order.size(); i++) {
+            same = same && order[i].getId() == expected_order[i] + 1;
+        }
+        CHECK(same);
+    }
+}
+
+#endif
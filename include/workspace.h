@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+
+#include "job.h"
+
+template<class Item>
+class WorkspaceLease;
+
+/**
+ * @brief Scratch memory borrowed by the scheduling algorithms.
+ *
+ * Buffers are cleared between calls instead of being freed, so after the
+ * first solve of a given size the algorithms run without touching the heap
+ * (tests/allocations.cpp counts every operator new to check it).
+ *
+ * The workspace is not reentrant: an algorithm borrows it with a
+ * WorkspaceLease for its whole run, and reserve() clears every buffer, so
+ * an algorithm holding the lease must not call another one that borrows
+ * the same workspace. A second lease fails an assertion.
+ *
+ * @tparam Item The type of items in the problem.
+ */
+template<class Item>
+class Workspace {
+    friend class WorkspaceLease<Item>;
+
+private:
+    size_t allocation_count; /**< Number of times any buffer had to grow. */
+    bool borrowed; /**< Whether an algorithm holds a lease on the workspace. */
+
+public:
+    std::vector<Item> backup; /**< Copy of the list restored when an algorithm ends. */
+    std::vector<Item> helper; /**< General purpose list (candidates, best order). */
+    std::vector<Item> first_queue; /**< Storage of the first priority queue. */
+    std::vector<Item> second_queue; /**< Storage of the second priority queue. */
+    std::vector<Item> third_queue; /**< Storage of the third priority queue. */
+    std::vector<int> first_index; /**< First list of item positions. */
+    std::vector<int> second_index; /**< Second list of item positions. */
+    std::vector<int> third_index; /**< Third list of item positions. */
+    std::vector<int> fourth_index; /**< Fourth list of item positions. */
+
+    /**
+     * @brief Default constructor for Workspace class.
+     */
+    Workspace();
+
+    /**
+     * @brief Make every buffer able to hold the given number of items and clear it.
+     * @param size The number of items the buffers must hold without growing.
+     */
+    void reserve(size_t size);
+
+    /**
+     * @brief Clear every buffer, keeping its memory.
+     */
+    void reset();
+
+    /**
+     * @brief Get the number of times the buffers of the workspace grew since construction.
+     *
+     * Allocations outside the workspace (the list of the problem, results,
+     * solvers) are not counted.
+     *
+     * @return The number of times a buffer had to grow.
+     */
+    size_t getAllocationCount() const { return allocation_count; }
+
+    /**
+     * @brief Check whether an algorithm holds a lease on the workspace.
+     * @return true While a WorkspaceLease of this workspace exists.
+     */
+    bool isBorrowed() const { return borrowed; }
+};
+
+/**
+ * @brief Holds a Workspace for the duration of one algorithm.
+ *
+ * The constructor reserves (and so clears) the buffers, the destructor
+ * gives the workspace back. For SoaJob items it also removes the store rows
+ * added during the algorithm, so repeated runs do not grow the store; the
+ * algorithm must leave its list made of the items it started with.
+ *
+ * @tparam Item The type of items in the problem.
+ */
+template<class Item>
+class WorkspaceLease {
+private:
+    Workspace<Item> &scratch; /**< The borrowed workspace. */
+    JobRowScope<Item> rows; /**< Removes the item rows added during the algorithm. */
+
+public:
+    /**
+     * @brief Borrow the workspace and make its buffers able to hold the given number of items.
+     * @param scratch_s The workspace (must not be borrowed already).
+     * @param size The number of items the buffers must hold without growing.
+     */
+    WorkspaceLease(Workspace<Item> &scratch_s, size_t size) : scratch(scratch_s) {
+        assert(!scratch.borrowed && "The workspace is already used by another algorithm on this thread");
+        scratch.borrowed = true;
+        scratch.reserve(size);
+    }
+
+    ~WorkspaceLease() { scratch.borrowed = false; }
+
+    WorkspaceLease(const WorkspaceLease &) = delete;
+    WorkspaceLease &operator=(const WorkspaceLease &) = delete;
+};
+
+/**
+ * @brief A priority queue built on top of a borrowed vector.
+ *
+ * Behaves exactly like std::priority_queue (same heap operations, same
+ * order of equal items), but does not own its storage.
+ *
+ * @tparam Item The type of items in the queue.
+ */
+template<class Item>
+class ScratchQueue {
+public:
+    using Compare = bool (*)(const Item &, const Item &); /**< Ordering of the queue. */
+
+private:
+    std::vector<Item> &storage; /**< The borrowed heap storage. */
+    Compare compare; /**< The ordering of the queue. */
+
+public:
+    /**
+     * @brief Constructor taking the storage to use.
+     * @param storage_s The vector to keep the heap in (it is cleared).
+     * @param compare_s The ordering, with the same meaning as in std::priority_queue.
+     */
+    ScratchQueue(std::vector<Item> &storage_s, Compare compare_s) : storage(storage_s), compare(compare_s) {
+        storage.clear();
+    }
+
+    bool empty() const { return storage.empty(); }
+
+    size_t size() const { return storage.size(); }
+
+    const Item &top() const { return storage.front(); }
+
+    void push(const Item &item) {
+        storage.push_back(item);
+        std::push_heap(storage.begin(), storage.end(), compare);
+    }
+
+    void pop() {
+        std::pop_heap(storage.begin(), storage.end(), compare);
+        storage.pop_back();
+    }
+};
@@ -0,0 +1,146 @@
+import argparse
+import math
+import os
+import re
+import shutil
+import subprocess
+import sys
+
+# Builds the project in several release configurations, runs the benchmark
+# with each of them and reports how much faster every configuration is than
+# a plain release build. The PGO configurations are built twice: once
+# instrumented, trained on the benchmark and the small data files, and once
+# more using the collected profiles.
+
+parser = argparse.ArgumentParser(description="Compare release, LTO, native and PGO builds on the benchmark.")
+parser.add_argument('--items', type=int, default=100000, help="Largest instance of the parallel machines part.")
+parser.add_argument('--machines', type=int, default=64, help="Largest number of machines.")
+parser.add_argument('--seed', type=int, default=1, help="Seed of the generated instances.")
+parser.add_argument('--repeats', type=int, default=3,
+                    help="Runs of the benchmark per configuration; the best time of every measurement is kept.")
+parser.add_argument('--variants', type=str, default="release,lto,native,pgo,pgo-native",
+                    help="Comma separated configurations to build (release is always built).")
+parser.add_argument('--build-dir', type=str, default="build-bench", help="Directory for all the builds.")
+parser.add_argument('--cmake-arg', action='append', default=[], help="Extra argument for cmake (repeatable).")
+args = parser.parse_args()
+
+is_windows = sys.platform.startswith('win')
+exe_suffix = ".exe" if is_windows else ""
+source_dir = os.path.dirname(os.path.abspath(__file__))
+build_root = os.path.abspath(args.build_dir)
+
+# Options of every configuration: LTO, -march=native, PGO.
+VARIANTS = {
+    "release": {"lto": False, "native": False, "pgo": False},
+    "lto": {"lto": True, "native": False, "pgo": False},
+    "native": {"lto": True, "native": True, "pgo": False},
+    "pgo": {"lto": True, "native": False, "pgo": True},
+    "pgo-native": {"lto": True, "native": True, "pgo": True},
+}
+
+# Data files used to train the PGO builds (the larger ones take too long for permutationSort).
+TRAINING_DATA = ["test_1.txt", "test_2.txt", "test_3.txt"]
+
+
+def run_command(command, cwd=None, capture=False):
+    print("> " + " ".join(command), flush=True)
+    try:
+        if capture:
+            return subprocess.run(command, cwd=cwd, check=True, stdout=subprocess.PIPE,
+                                  universal_newlines=True).stdout
+        subprocess.run(command, cwd=cwd, check=True, stdout=subprocess.DEVNULL)
+    except (subprocess.CalledProcessError, OSError) as e:
+        print(f"Command failed: {e}")
+        sys.exit(1)
+    return ""
+
+
+def build_system():
+    if shutil.which("ninja"):
+        return "Ninja"
+    if shutil.which("make"):
+        return "Unix Makefiles"
+    print("Neither make nor ninja build system found. Please install one of them.")
+    sys.exit(1)
+
+
+def configure_and_build(build_dir, options, pgo_mode):
+    command = ["cmake", "-S", source_dir, "-B", build_dir, "-G", build_system(),
+               "-DCMAKE_BUILD_TYPE=Release",
+               "-DENABLE_LTO=" + ("ON" if options["lto"] else "OFF"),
+               "-DENABLE_NATIVE=" + ("ON" if options["native"] else "OFF"),
+               "-DPGO_MODE=" + pgo_mode] + args.cmake_arg
+    run_command(command)
+    run_command(["cmake", "--build", build_dir, "--config", "Release"])
+
+
+def executable(build_dir, name):
+    return os.path.join(build_dir, name + exe_suffix)
+
+
+def bench_command(build_dir):
+    return [executable(build_dir, "bench"), str(args.items), str(args.machines), str(args.seed)]
+
+
+def train(build_dir):
+    profile_dir = os.path.join(build_dir, "pgo-profiles")
+    shutil.rmtree(profile_dir, ignore_errors=True)
+    os.makedirs(profile_dir)
+    environment = dict(os.environ, LLVM_PROFILE_FILE=os.path.join(profile_dir, "%p.profraw"))
+    for data_file in TRAINING_DATA:
+        subprocess.run([executable(build_dir, "main"), os.path.join(source_dir, "data", data_file)],
+                       check=True, stdout=subprocess.DEVNULL, env=environment)
+    subprocess.run(bench_command(build_dir), check=True, stdout=subprocess.DEVNULL, env=environment)
+
+    # Clang needs its raw profiles merged; GCC reads its .gcda files directly.
+    raw_profiles = [os.path.join(profile_dir, f) for f in os.listdir(profile_dir) if f.endswith(".profraw")]
+    if raw_profiles:
+        run_command(["llvm-profdata", "merge", "-o", os.path.join(profile_dir, "default.profdata")] + raw_profiles)
+
+
+def parse_bench(output):
+    """Returns the time in ms of every measurement, keyed by its row."""
+    times = {}
+    for line in output.splitlines():
+        words = line.split()
+        if len(words) == 7 and words[0].isdigit():
+            times[f"{words[0]} zadań, {words[1]} maszyn"] = float(words[2])
+        elif len(words) == 4 and re.match(r"^[a-z-]+$", words[0]) and words[1].isdigit():
+            times[f"{words[0]} ({words[1]} zadań)"] = float(words[2])
+    return times
+
+
+variants = ["release"] + [v for v in args.variants.split(",") if v and v != "release"]
+for variant in variants:
+    if variant not in VARIANTS:
+        print(f"Unknown configuration {variant}, choose from: {', '.join(VARIANTS)}")
+        sys.exit(1)
+
+results = {}
+for variant in variants:
+    options = VARIANTS[variant]
+    build_dir = os.path.join(build_root, variant)
+    if options["pgo"]:
+        configure_and_build(build_dir, options, "GENERATE")
+        train(build_dir)
+        configure_and_build(build_dir, options, "USE")
+    else:
+        configure_and_build(build_dir, options, "OFF")
+    results[variant] = {}
+    for _ in range(max(1, args.repeats)):
+        for row, ms in parse_bench(run_command(bench_command(build_dir), capture=True)).items():
+            results[variant][row] = min(ms, results[variant].get(row, ms))
+
+# Per-row times and the geometric mean of the speedup over the plain release build.
+baseline = results["release"]
+rows = list(baseline.keys())
+print()
+print(f"{'pomiar':32}" + "".join(f"{v:>12}" for v in variants))
+for row in rows:
+    print(f"{row:32}" + "".join(f"{results[v].get(row, float('nan')):12.3f}" for v in variants))
+print()
+for variant in variants:
+    speedups = [baseline[row] / results[variant][row] for row in rows
+                if results[variant].get(row, 0) > 0 and baseline[row] > 0]
+    gain = math.exp(sum(math.log(s) for s in speedups) / len(speedups)) if speedups else float('nan')
+    print(f"{variant:12} przyspieszenie względem release: {gain:6.3f}x ({(gain - 1) * 100:+.1f}%)")
@@ -0,0 +1,48 @@
+#include "critical_path.h"
+#include "item.h"
+#include "job.h"
+
+template<class Item>
+CriticalPath analyseCriticalPath(const std::vector<Item> &order, std::vector<int> &finish_times) {
+    CriticalPath path;
+    finish_times.resize(order.size());
+    if (order.empty()) {
+        return path;
+    }
+
+    int time = 0;
+    std::size_t block_begin = 0;
+    for (std::size_t i = 0; i < order.size(); i++) {
+        const Item &item = order[i];
+        // An item the machine has to wait for starts a new block.
+        if (i == 0 || item.getOccurTime() > time) {
+            block_begin = i;
+            time = item.getOccurTime();
+        }
+        time += item.getWorkTime();
+        finish_times[i] = time;
+
+        if (i == 0 || time + item.getIdleTime() >= path.time) {
+            path.time = time + item.getIdleTime();
+            path.critical = i;
+            path.block_begin = block_begin;
+        }
+    }
+
+    const int critical_idle_time = order[path.critical].getIdleTime();
+    const int block_occur_time = order[path.block_begin].getOccurTime();
+    for (std::size_t i = path.critical + 1; i-- > path.block_begin;) {
+        if (path.interference == CriticalPath::NONE && order[i].getIdleTime() < critical_idle_time) {
+            path.interference = i;
+        }
+        if (order[i].getOccurTime() < block_occur_time) {
+            path.block_starts_earliest = false;
+        }
+    }
+    return path;
+}
+
+
+template CriticalPath analyseCriticalPath<Item<int>>(const std::vector<Item<int>> &, std::vector<int> &);
+template CriticalPath analyseCriticalPath<Item<short>>(const std::vector<Item<short>> &, std::vector<int> &);
+template CriticalPath analyseCriticalPath<SoaJob>(const std::vector<SoaJob> &, std::vector<int> &);
@@ -0,0 +1,34 @@
+#include "generator.h"
+#include "item.h"
+
+#include <random>
+
+template<class Item>
+std::vector<Item> generateInstance(std::size_t count, uint32_t seed, int max_work_time, int max_occur_time,
+                                   int max_idle_time) {
+    int spread = int(count) * max_work_time / 2;
+    if (max_occur_time < 0) {
+        max_occur_time = spread;
+    }
+    if (max_idle_time < 0) {
+        max_idle_time = spread;
+    }
+
+    // The distributions of the standard library differ between
+    // implementations, so the raw engine output is reduced by hand.
+    std::mt19937 engine(seed);
+    auto draw = [&](int low, int high) { return low + int(engine() % uint32_t(high - low + 1)); };
+
+    std::vector<Item> items;
+    items.reserve(count);
+    for (std::size_t i = 0; i < count; i++) {
+        int occur_time = draw(0, max_occur_time);
+        int work_time = draw(1, max_work_time);
+        int idle_time = draw(0, max_idle_time);
+        items.emplace_back(int(i) + 1, occur_time, work_time, idle_time);
+    }
+    return items;
+}
+
+
+template std::vector<Item<int>> generateInstance<Item<int>>(std::size_t, uint32_t, int, int, int);
@@ -0,0 +1,388 @@
+#include "incremental_schedule.h"
+#include "item.h"
+
+#include <algorithm>
+#include <climits>
+
+namespace {
+
+/// Whether waiting item a is chosen after waiting item b (heap order).
+template<class Item>
+bool chosenAfter(const Item &a, const Item &b) {
+    return a.getIdleTime() < b.getIdleTime() || (a.getIdleTime() == b.getIdleTime() && a.getId() > b.getId());
+}
+
+} // namespace
+
+PositionTree::PositionTree() : leaves(1), earliest(2, INT_MAX), latest_end(2, INT_MIN) {}
+
+void PositionTree::reserve(std::size_t size) {
+    if (size <= leaves) {
+        return;
+    }
+    std::size_t old_leaves = leaves;
+    while (leaves < size) {
+        leaves *= 2;
+    }
+    std::vector<int> old_earliest(earliest.begin() + long(old_leaves), earliest.end());
+    std::vector<int> old_latest_end(latest_end.begin() + long(old_leaves), latest_end.end());
+    earliest.assign(2 * leaves, INT_MAX);
+    latest_end.assign(2 * leaves, INT_MIN);
+    std::copy(old_earliest.begin(), old_earliest.end(), earliest.begin() + long(leaves));
+    std::copy(old_latest_end.begin(), old_latest_end.end(), latest_end.begin() + long(leaves));
+    update(0, old_leaves);
+}
+
+void PositionTree::clear(std::size_t at) {
+    earliest[leaves + at] = INT_MAX;
+    latest_end[leaves + at] = INT_MIN;
+}
+
+void PositionTree::update(std::size_t first, std::size_t last) {
+    if (first >= last || leaves == 1) {
+        return;
+    }
+    // The parents of the range, one level at a time.
+    std::size_t low = (leaves + first) / 2, high = (leaves + last - 1) / 2;
+    while (true) {
+        for (std::size_t node = low; node <= high; node++) {
+            earliest[node] = std::min(earliest[2 * node], earliest[2 * node + 1]);
+            latest_end[node] = std::max(latest_end[2 * node], latest_end[2 * node + 1]);
+        }
+        if (low == 1) {
+            break;
+        }
+        low /= 2;
+        high /= 2;
+    }
+}
+
+void PositionTree::collect(std::size_t node, std::size_t begin, std::size_t end, std::size_t first, int time,
+                           std::vector<int> &positions) const {
+    if (end <= first || earliest[node] > time) {
+        return;
+    }
+    if (node >= leaves) {
+        positions.push_back(int(begin));
+        return;
+    }
+    std::size_t middle = begin + (end - begin) / 2;
+    collect(2 * node, begin, middle, first, time, positions);
+    collect(2 * node + 1, middle, end, first, time, positions);
+}
+
+void PositionTree::findOccurred(std::size_t first, int time, std::vector<int> &positions) const {
+    positions.clear();
+    collect(1, 0, leaves, first, time, positions);
+}
+
+template<class Item>
+IncrementalSchedule<Item>::IncrementalSchedule()
+    : first_affected(NOTHING_AFFECTED), repaired_count(0), total_work(0) {}
+
+template<class Item>
+IncrementalSchedule<Item>::IncrementalSchedule(const std::vector<Item> &items_s) : IncrementalSchedule() {
+    for (const Item &item: items_s) {
+        if (slot_of_id.count(item.getId()) == 0) {
+            int slot = store(item);
+            account(slot, true);
+            touch(slot);
+        }
+    }
+    affect(0);
+    repair();
+}
+
+template<class Item>
+std::size_t IncrementalSchedule<Item>::firstDecisionFrom(int time) const {
+    return std::size_t(std::lower_bound(decision.begin(), decision.end(), time) - decision.begin());
+}
+
+template<class Item>
+void IncrementalSchedule<Item>::affect(std::size_t at) {
+    first_affected = std::min(first_affected, at);
+}
+
+template<class Item>
+void IncrementalSchedule<Item>::touch(int slot) {
+    if (!is_touched[slot]) {
+        is_touched[slot] = 1;
+        touched.push_back(slot);
+    }
+}
+
+template<class Item>
+void IncrementalSchedule<Item>::account(int slot, bool add) {
+    const Item &item = items[slot];
+    if (add) {
+        by_occur_time.emplace(item.getOccurTime(), item.getId(), slot);
+    } else {
+        by_occur_time.erase(std::make_tuple(item.getOccurTime(), item.getId(), slot));
+    }
+
+    if (add) {
+        longest_items.insert(item.getOccurTime() + item.getWorkTime() + item.getIdleTime());
+        occur_times.insert(item.getOccurTime());
+        idle_times.insert(item.getIdleTime());
+        total_work += item.getWorkTime();
+    } else {
+        longest_items.erase(longest_items.find(item.getOccurTime() + item.getWorkTime() + item.getIdleTime()));
+        occur_times.erase(occur_times.find(item.getOccurTime()));
+        idle_times.erase(idle_times.find(item.getIdleTime()));
+        total_work -= item.getWorkTime();
+    }
+}
+
+template<class Item>
+int IncrementalSchedule<Item>::store(const Item &item) {
+    int slot;
+    if (free_slots.empty()) {
+        slot = int(items.size());
+        items.push_back(item);
+        live.push_back(1);
+        position.push_back(-1);
+        is_touched.push_back(0);
+        mark.push_back(0);
+    } else {
+        slot = free_slots.back();
+        free_slots.pop_back();
+        items[slot] = item;
+        live[slot] = 1;
+        position[slot] = -1;
+    }
+    slot_of_id[item.getId()] = slot;
+    return slot;
+}
+
+template<class Item>
+bool IncrementalSchedule<Item>::addItem(const Item &item) {
+    if (slot_of_id.count(item.getId()) != 0) {
+        return false;
+    }
+
+    int slot = store(item);
+    account(slot, true);
+    touch(slot);
+    affect(firstDecisionFrom(item.getOccurTime()));
+    return true;
+}
+
+template<class Item>
+bool IncrementalSchedule<Item>::removeItem(int id) {
+    auto found = slot_of_id.find(id);
+    if (found == slot_of_id.end()) {
+        return false;
+    }
+
+    int slot = found->second;
+    slot_of_id.erase(found);
+    account(slot, false);
+    live[slot] = 0;
+    touch(slot);
+    // The slot is freed after the repair, so that it does not get mixed up
+    // with an item added in the same batch.
+    removed.push_back(slot);
+    if (position[slot] >= 0) {
+        affect(std::size_t(position[slot]));
+    }
+    return true;
+}
+
+template<class Item>
+bool IncrementalSchedule<Item>::updateItem(const Item &item) {
+    auto found = slot_of_id.find(item.getId());
+    if (found == slot_of_id.end()) {
+        return false;
+    }
+
+    int slot = found->second;
+    account(slot, false);
+    items[slot] = item;
+    account(slot, true);
+    touch(slot);
+    if (position[slot] >= 0) {
+        affect(std::size_t(position[slot]));
+    }
+    affect(firstDecisionFrom(item.getOccurTime()));
+    return true;
+}
+
+template<class Item>
+void IncrementalSchedule<Item>::repair() {
+    if (first_affected == NOTHING_AFFECTED) {
+        return;
+    }
+
+    const std::size_t old_size = order.size();
+    const std::size_t from = std::min(first_affected, old_size);
+
+    // The old schedule from the affected position on and the new one are
+    // compared by a balance per slot: +1 when the new schedule takes the
+    // slot, -1 when the old one does. Removed items start at +1 and added
+    // ones at -1, so all balances are 0 exactly when the new schedule has
+    // taken the same items as the old one, apart from the removed and added
+    // ones. Changed items also have to be taken by both, as the old schedule
+    // used their old times.
+    int unbalanced = 0;
+    int changed_waiting = 0;
+    std::size_t added = 0, removed_scheduled = 0;
+    for (int slot: touched) {
+        if (live[slot] && position[slot] < 0) {
+            mark[slot] = -1;
+            unbalanced++;
+            added++;
+        } else if (live[slot]) {
+            changed_waiting++;
+        } else if (position[slot] >= 0) {
+            mark[slot] = 1;
+            unbalanced++;
+            removed_scheduled++;
+        }
+    }
+    auto balance = [&](int slot, int change) {
+        unbalanced -= (mark[slot] != 0) ? 1 : 0;
+        mark[slot] += change;
+        unbalanced += (mark[slot] != 0) ? 1 : 0;
+    };
+
+    // Items not yet taken at the affected position: the ones waiting then
+    // are the unchanged ones the tree finds behind it and the changed or
+    // added ones that occurred by then; all items occurring later are taken
+    // from the occurrence order as the time passes.
+    int now = (from > 0) ? finish[from - 1] : 0;
+    ready.clear();
+    tree.findOccurred(from, now, waiting_positions);
+    for (int at: waiting_positions) {
+        if (!is_touched[order[std::size_t(at)]]) {
+            ready.push_back(order[std::size_t(at)]);
+        }
+    }
+    for (int slot: touched) {
+        if (live[slot] && items[slot].getOccurTime() <= now) {
+            ready.push_back(slot);
+        }
+    }
+    auto later = [this](int a, int b) { return chosenAfter(items[a], items[b]); };
+    std::make_heap(ready.begin(), ready.end(), later);
+    auto pending = by_occur_time.upper_bound(std::make_tuple(now, INT_MAX, INT_MAX));
+
+    new_order.clear();
+    new_decision.clear();
+    new_finish.clear();
+    std::size_t old_next = from;
+    std::size_t reused_from = old_size;
+
+    while (!ready.empty() || pending != by_occur_time.end()) {
+        if (ready.empty() && std::get<0>(*pending) > now) {
+            now = std::get<0>(*pending);
+        }
+        while (pending != by_occur_time.end() && std::get<0>(*pending) <= now) {
+            ready.push_back(std::get<2>(*pending));
+            std::push_heap(ready.begin(), ready.end(), later);
+            ++pending;
+        }
+
+        std::pop_heap(ready.begin(), ready.end(), later);
+        const int slot = ready.back();
+        ready.pop_back();
+
+        new_order.push_back(slot);
+        new_decision.push_back(now);
+        now += items[slot].getWorkTime();
+        new_finish.push_back(now);
+
+        if (is_touched[slot] && position[slot] >= 0) {
+            changed_waiting--;
+        }
+        balance(slot, 1);
+
+        // The old schedule had taken this many items at the same point.
+        const std::size_t taken = from + new_order.size() + removed_scheduled;
+        const std::size_t old_taken = (taken > added) ? taken - added : 0;
+        while (old_next < old_taken && old_next < old_size) {
+            balance(order[old_next++], -1);
+        }
+        if (unbalanced == 0 && changed_waiting == 0 && old_next == old_taken && old_taken > 0 &&
+            finish[old_taken - 1] == now) {
+            reused_from = old_taken;
+            break;
+        }
+    }
+
+    // Clear the balances before the positions change.
+    for (int slot: new_order) {
+        mark[slot] = 0;
+    }
+    for (std::size_t i = from; i < old_next; i++) {
+        mark[order[i]] = 0;
+    }
+    for (int slot: touched) {
+        mark[slot] = 0;
+        is_touched[slot] = 0;
+    }
+
+    // Replace the affected part with the new decisions: in place when the
+    // number of items taken did not change, otherwise the rest moves.
+    const std::size_t repaired_end = from + new_order.size();
+    if (repaired_end == reused_from) {
+        std::copy(new_order.begin(), new_order.end(), order.begin() + long(from));
+        std::copy(new_decision.begin(), new_decision.end(), decision.begin() + long(from));
+        std::copy(new_finish.begin(), new_finish.end(), finish.begin() + long(from));
+    } else {
+        auto splice = [&](std::vector<int> &values, const std::vector<int> &replacement) {
+            values.erase(values.begin() + long(from), values.begin() + long(reused_from));
+            values.insert(values.begin() + long(from), replacement.begin(), replacement.end());
+        };
+        splice(order, new_order);
+        splice(decision, new_decision);
+        splice(finish, new_finish);
+    }
+
+    for (int slot: removed) {
+        position[slot] = -1;
+        free_slots.push_back(slot);
+    }
+    const std::size_t changed_end = (repaired_end == reused_from) ? repaired_end : order.size();
+    tree.reserve(order.size());
+    for (std::size_t i = from; i < changed_end; i++) {
+        const Item &item = items[order[i]];
+        position[order[i]] = int(i);
+        tree.set(i, item.getOccurTime(), finish[i] + item.getIdleTime());
+    }
+    for (std::size_t i = order.size(); i < old_size; i++) {
+        tree.clear(i);
+    }
+    tree.update(from, (repaired_end == reused_from) ? repaired_end : std::max(order.size(), old_size));
+
+    touched.clear();
+    removed.clear();
+    first_affected = NOTHING_AFFECTED;
+    repaired_count = new_order.size();
+}
+
+template<class Item>
+int IncrementalSchedule<Item>::getTime() {
+    repair();
+    return order.empty() ? 0 : tree.latestEnd();
+}
+
+template<class Item>
+void IncrementalSchedule<Item>::getOrder(std::vector<Item> &scheduled) {
+    repair();
+    scheduled.clear();
+    for (int slot: order) {
+        scheduled.push_back(items[slot]);
+    }
+}
+
+template<class Item>
+int IncrementalSchedule<Item>::getLowerBound() const {
+    if (longest_items.empty()) {
+        return 0;
+    }
+    long long load = *occur_times.begin() + total_work + *idle_times.begin();
+    return int(std::max<long long>(*longest_items.rbegin(), load));
+}
+
+
+template class IncrementalSchedule<Item<int>>;
@@ -5,10 +5,10 @@ Item<T>::Item() : id(0), occur_time(0), work_time(0), idle_time(0) {}
 
 template <class T>
 Item<T>::Item(int id_s, int occur_time_s, int work_time_s, int idle_time_s) {
-    id = id_s;
-    occur_time = occur_time_s;
-    work_time = work_time_s;
-    idle_time = idle_time_s;
+    id = T(id_s);
+    occur_time = T(occur_time_s);
+    work_time = T(work_time_s);
+    idle_time = T(idle_time_s);
 }
 
 template <class T>
@@ -25,3 +25,7 @@ template <class T>
 bool Item<T>::compareByIdleTime(const Item& other) const {
     return idle_time < other.idle_time;
 }
+
+
+template class Item<int>;
+template class Item<short>;
@@ -0,0 +1,34 @@
+#include "job.h"
+
+#include <algorithm>
+#include <cassert>
+
+SoaJobStore::SoaJobStore() { add(0, 0, 0, 0); }
+
+uint32_t SoaJobStore::add(int id_s, int occur_time_s, int work_time_s, int idle_time_s) {
+    id.push_back(id_s);
+    occur_time.push_back(occur_time_s);
+    work_time.push_back(work_time_s);
+    idle_time.push_back(idle_time_s);
+    return uint32_t(id.size() - 1);
+}
+
+void SoaJobStore::truncate(std::size_t rows) {
+    rows = std::max<std::size_t>(rows, 1);
+    if (rows < id.size()) {
+        id.resize(rows);
+        occur_time.resize(rows);
+        work_time.resize(rows);
+        idle_time.resize(rows);
+    }
+}
+
+SoaJobStore &SoaJob::own() {
+    SoaJobStore &store = SoaJobStore::local();
+    assert(row < store.size() && "SoaJob changed after its row was truncated or on another thread");
+    if (!owned) {
+        row = store.add(store.id[row], store.occur_time[row], store.work_time[row], store.idle_time[row]);
+        owned = true;
+    }
+    return store;
+}
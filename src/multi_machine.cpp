@@ -0,0 +1,124 @@
+#include "multi_machine.h"
+#include "item.h"
+#include "job.h"
+
+#include <algorithm>
+#include <functional>
+
+template<class Item>
+MachineScheduler<Item>::MachineScheduler(int machine_count_s) : machine_count(std::max(1, machine_count_s)) {}
+
+template<class Item>
+int MachineScheduler<Item>::dispatch(const std::vector<Item> &items, MachineSchedule &schedule) {
+    const int size = int(items.size());
+    schedule.order.clear();
+    schedule.machine.assign(size, 0);
+    schedule.start.assign(size, 0);
+    schedule.time = 0;
+
+    by_occur_time.resize(size);
+    for (int i = 0; i < size; i++) {
+        by_occur_time[i] = i;
+    }
+    std::sort(by_occur_time.begin(), by_occur_time.end(), [&](int a, int b) {
+        return items[a].getOccurTime() < items[b].getOccurTime() ||
+               (items[a].getOccurTime() == items[b].getOccurTime() && a < b);
+    });
+
+    // Machines with the same free moment are taken by number, so the
+    // schedule does not depend on the heap's history.
+    machines.clear();
+    for (int machine = 0; machine < machine_count; machine++) {
+        machines.emplace_back(0, machine);
+    }
+    auto later = std::greater<std::pair<int, int>>();
+    waiting.clear();
+
+    // Decisions are made in time order: a machine that became free while
+    // another one was waiting for the next item to occur has nothing to do
+    // before that moment either.
+    int now = 0;
+    int next = 0;
+    while (int(schedule.order.size()) < size) {
+        std::pop_heap(machines.begin(), machines.end(), later);
+        now = std::max(now, machines.back().first);
+        const int machine = machines.back().second;
+
+        if (waiting.empty() && items[by_occur_time[next]].getOccurTime() > now) {
+            now = items[by_occur_time[next]].getOccurTime();
+        }
+        while (next < size && items[by_occur_time[next]].getOccurTime() <= now) {
+            waiting.emplace_back(items[by_occur_time[next]].getIdleTime(), -by_occur_time[next]);
+            std::push_heap(waiting.begin(), waiting.end());
+            next++;
+        }
+
+        std::pop_heap(waiting.begin(), waiting.end());
+        const int chosen = -waiting.back().second;
+        waiting.pop_back();
+
+        const Item &item = items[chosen];
+        schedule.order.push_back(chosen);
+        schedule.machine[chosen] = machine;
+        schedule.start[chosen] = now;
+        const int finish = now + item.getWorkTime();
+        schedule.time = std::max(schedule.time, finish + item.getIdleTime());
+
+        machines.back().first = finish;
+        std::push_heap(machines.begin(), machines.end(), later);
+    }
+
+    return schedule.time;
+}
+
+template<class Item>
+int MachineScheduler<Item>::evaluate(const std::vector<Item> &items, const MachineSchedule &schedule) {
+    machine_time.assign(machine_count, 0);
+    int total_time = 0;
+
+    for (int position: schedule.order) {
+        const Item &item = items[position];
+        int &now = machine_time[schedule.machine[position]];
+        now = std::max(now, item.getOccurTime()) + item.getWorkTime();
+        total_time = std::max(total_time, now + item.getIdleTime());
+    }
+    return total_time;
+}
+
+template<class Item>
+int MachineScheduler<Item>::lowerBound(const std::vector<Item> &items, int machine_count) {
+    const std::size_t used = std::min(items.size(), std::size_t(std::max(1, machine_count)));
+    if (used == 0) {
+        return 0;
+    }
+
+    long long total_work = 0;
+    int longest_item = 0;
+    std::vector<int> occur_times, idle_times;
+    occur_times.reserve(items.size());
+    idle_times.reserve(items.size());
+    for (const Item &item: items) {
+        total_work += item.getWorkTime();
+        longest_item = std::max(longest_item, item.getOccurTime() + item.getWorkTime() + item.getIdleTime());
+        occur_times.push_back(item.getOccurTime());
+        idle_times.push_back(item.getIdleTime());
+    }
+    std::partial_sort(occur_times.begin(), occur_times.begin() + used, occur_times.end());
+    std::partial_sort(idle_times.begin(), idle_times.begin() + used, idle_times.end());
+
+    long long load_bound = -1;
+    long long load = total_work;
+    for (std::size_t k = 1; k <= used; k++) {
+        load += occur_times[k - 1] + idle_times[k - 1];
+        long long bound = (load + (long long) k - 1) / (long long) k;
+        if (load_bound < 0 || bound < load_bound) {
+            load_bound = bound;
+        }
+    }
+    return int(std::max<long long>(longest_item, load_bound));
+}
+
+
+template class MachineScheduler<Item<int>>;
+template class MachineScheduler<Item<short>>;
+template class MachineScheduler<SoaJob>;
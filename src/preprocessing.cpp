@@ -0,0 +1,196 @@
+#include "preprocessing.h"
+#include "item.h"
+#include "job.h"
+#include "critical_path.h"
+#include "multi_machine.h"
+#include "subset_solver.h"
+#include "tiny_solver.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+template<class Item>
+InstanceReduction<Item>::InstanceReduction(const std::vector<Item> &items, std::size_t exact_limit_s)
+    : sorted(items), exact_limit(std::min(exact_limit_s, SUBSET_SOLVER_LIMIT)) {
+    std::sort(sorted.begin(), sorted.end(), [](const Item &a, const Item &b) {
+        return a.getOccurTime() < b.getOccurTime() ||
+               (a.getOccurTime() == b.getOccurTime() && a.getId() < b.getId());
+    });
+    for (const Item &item: sorted) {
+        plain.emplace_back(item.getId(), item.getOccurTime(), item.getWorkTime(), item.getIdleTime());
+    }
+
+    // The earliest moment all items so far can be finished; if the next
+    // item occurs no sooner, nothing before it has to wait for it.
+    int finish_time = 0;
+    ReductionBlock block;
+    for (std::size_t i = 0; i < sorted.size(); i++) {
+        const Item &item = sorted[i];
+        if (block.size == 0) {
+            block.first = i;
+            block.occur_offset = item.getOccurTime();
+            block.idle_offset = item.getIdleTime();
+        }
+        block.size++;
+        block.idle_offset = std::min(block.idle_offset, item.getIdleTime());
+        finish_time = std::max(finish_time, item.getOccurTime()) + item.getWorkTime();
+
+        if (i + 1 == sorted.size() || finish_time <= sorted[i + 1].getOccurTime()) {
+            blocks.push_back(block);
+            block = ReductionBlock();
+        }
+    }
+}
+
+template<class Item>
+std::size_t InstanceReduction<Item>::getLargestBlock() const {
+    std::size_t largest = 0;
+    for (const ReductionBlock &block: blocks) {
+        largest = std::max(largest, block.size);
+    }
+    return largest;
+}
+
+template<class Item>
+void InstanceReduction<Item>::getBlockItems(std::size_t block, std::vector<Item> &normalised) const {
+    const ReductionBlock &chosen = blocks[block];
+    normalised.clear();
+    for (std::size_t i = chosen.first; i < chosen.first + chosen.size; i++) {
+        const Item &item = sorted[i];
+        normalised.emplace_back(item.getId(), item.getOccurTime() - chosen.occur_offset, item.getWorkTime(),
+                                item.getIdleTime() - chosen.idle_offset);
+    }
+}
+
+template<class Item>
+bool InstanceReduction<Item>::solveBlock(const ReductionBlock &block, std::vector<std::size_t> &order,
+                                         unsigned thread_count, std::size_t block_exact_limit,
+                                         SolveControl *control) const {
+    order.clear();
+    if (block.size == 1) {
+        order.push_back(block.first);
+        return true;
+    }
+
+    std::vector<ReductionItem> normalised;
+    for (std::size_t i = block.first; i < block.first + block.size; i++) {
+        const ReductionItem &item = plain[i];
+        normalised.emplace_back(item.getId(), item.getOccurTime() - block.occur_offset, item.getWorkTime(),
+                                item.getIdleTime() - block.idle_offset);
+    }
+
+    std::vector<ReductionItem> found;
+    bool exact = true;
+    if (block.size <= TINY_SOLVER_LIMIT) {
+        solveTinyInstance(normalised, found);
+    } else if (block.size <= block_exact_limit) {
+        SubsetSolver<ReductionItem> solver(normalised, thread_count);
+        solver.solve(found, control);
+        exact = control == nullptr || !control->wasStopped();
+    } else {
+        MachineScheduler<ReductionItem> scheduler(1);
+        MachineSchedule schedule;
+        scheduler.dispatch(normalised, schedule);
+        for (int position: schedule.order) {
+            found.push_back(normalised[position]);
+        }
+        // A Schrage order without an interference item is optimal.
+        std::vector<int> finish_times;
+        exact = analyseCriticalPath(found, finish_times).isOptimal();
+    }
+
+    // Find the positions of the items by ID (IDs are unique within the block).
+    std::vector<std::pair<int, std::size_t>> by_id;
+    for (std::size_t i = block.first; i < block.first + block.size; i++) {
+        by_id.emplace_back(plain[i].getId(), i);
+    }
+    std::sort(by_id.begin(), by_id.end());
+    for (const ReductionItem &item: found) {
+        auto match = std::lower_bound(by_id.begin(), by_id.end(), std::make_pair(item.getId(), std::size_t(0)));
+        order.push_back(match->second);
+    }
+    return exact;
+}
+
+template<class Item>
+int InstanceReduction<Item>::solve(std::vector<Item> &order, bool &exact, unsigned thread_count,
+                                   SolveControl *control) const {
+    if (thread_count == 0) {
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    const unsigned worker_count = unsigned(std::min<std::size_t>(thread_count, blocks.size()));
+
+    // Largest blocks first, so that one big block does not start last.
+    std::vector<std::size_t> by_size(blocks.size());
+    for (std::size_t i = 0; i < by_size.size(); i++) {
+        by_size[i] = i;
+    }
+    std::stable_sort(by_size.begin(), by_size.end(),
+                     [this](std::size_t a, std::size_t b) { return blocks[a].size > blocks[b].size; });
+
+    // Every block has its own part of the control, joined after the threads end.
+    std::vector<SolveControl> parts;
+    if (control != nullptr) {
+        control->begin();
+        parts.assign(blocks.size(), control->part());
+    }
+
+    std::vector<std::vector<std::size_t>> block_orders(blocks.size());
+    std::vector<char> block_exact(blocks.size(), 0);
+    std::atomic<std::size_t> next(0);
+    std::atomic<bool> stopped(false);
+    auto work = [&]() {
+        for (std::size_t taken = next++; taken < by_size.size(); taken = next++) {
+            std::size_t block = by_size[taken];
+            // A block solved next to others gets one thread; a lone one may split its work.
+            unsigned inner_threads = (worker_count > 1) ? 1 : thread_count;
+            SolveControl *part = parts.empty() ? nullptr : &parts[block];
+            std::size_t block_exact_limit = stopped ? TINY_SOLVER_LIMIT : exact_limit;
+            block_exact[block] =
+                solveBlock(blocks[block], block_orders[block], inner_threads, block_exact_limit, part);
+            if (part != nullptr && part->wasStopped()) {
+                stopped = true;
+            }
+        }
+    };
+
+    if (worker_count <= 1) {
+        work();
+    } else {
+        std::vector<std::thread> workers;
+        for (unsigned i = 0; i < worker_count; i++) {
+            workers.emplace_back(work);
+        }
+        for (std::thread &worker: workers) {
+            worker.join();
+        }
+    }
+
+    order.clear();
+    exact = true;
+    int time = 0, total_time = 0, lower_bound = 0;
+    for (std::size_t block = 0; block < blocks.size(); block++) {
+        exact = exact && block_exact[block] && time <= blocks[block].occur_offset;
+        for (std::size_t position: block_orders[block]) {
+            const ReductionItem &item = plain[position];
+            time = std::max(time, item.getOccurTime()) + item.getWorkTime();
+            total_time = std::max(total_time, time + item.getIdleTime());
+            lower_bound = std::max(lower_bound, item.getOccurTime() + item.getWorkTime() + item.getIdleTime());
+            order.push_back(sorted[position]);
+        }
+    }
+
+    if (control != nullptr) {
+        for (const SolveControl &part: parts) {
+            control->join(part);
+        }
+        control->finish(blocks.size(), total_time, lower_bound);
+    }
+    return total_time;
+}
+
+
+template class InstanceReduction<Item<int>>;
+template class InstanceReduction<Item<short>>;
+template class InstanceReduction<SoaJob>;
@@ -1,7 +1,8 @@
 #include "problem.h"
 
 template<class Item>
-Problem<Item>::Problem() : list_size(0) {}
+Problem<Item>::Problem() : list_size(0), verbose(true), result_sink(nullptr), permutation_log(nullptr),
+                              solve_control(nullptr), memory_budget(SUBSET_SOLVER_MEMORY_BUDGET), thread_count(0) {}
 
 template<class Item>
 size_t Problem<Item>::getSize() { return list_size; }
@@ -14,43 +15,79 @@ void Problem<Item>::loadFromFile(const std::string &file_name) {
     std::ifstream input_file(file_name);
 
     if (!input_file.is_open()) {
-        std::cerr << "Nie udało się otworzyć pliku: " << file_name << "!\n";
+        std::cerr << "Nie udało się otworzyć pliku: " << file_name << "!\n";
         exit(EXIT_FAILURE);
     }
 
-    std::string temp;
-
-    if (!std::getline(input_file, temp)) {
+    if (input_file.peek() == std::ifstream::traits_type::eof()) {
         std::cerr << "Plik " << file_name << " jest pusty!\n";
         exit(EXIT_FAILURE);
-    } else {
-        list_size = std::stoi(temp);
+    }
+
+    std::string error;
+    if (!loadFromStream(input_file, error)) {
+        std::cerr << error << "\n";
+        exit(EXIT_FAILURE);
+    }
+    input_file.close();
+}
+
+template<class Item>
+bool Problem<Item>::loadFromStream(std::istream &input, std::string &error) {
+    std::string temp;
+    main_list.clear();
+    list_size = 0;
+
+    if (!std::getline(input, temp)) {
+        error = "Brak danych!";
+        return false;
+    }
+    std::istringstream header(temp);
+    int declared_size;
+    if (!(header >> declared_size) || declared_size < 0) {
+        error = "Dane zostały źle podzielone!";
+        return false;
     }
 
     Item new_item;
     int counter = 0, o_time, w_time, i_time;
-    while (std::getline(input_file, temp)) {
+    while (std::getline(input, temp)) {
         counter++;
         std::istringstream divide(temp);
         if (divide >> o_time >> w_time >> i_time) {
             new_item = Item(counter, o_time, w_time, i_time);
+            if (new_item.getId() != counter || new_item.getOccurTime() != o_time ||
+                new_item.getWorkTime() != w_time || new_item.getIdleTime() != i_time) {
+                error = "Wartości zadania nie mieszczą się w wybranym typie zadań!";
+                main_list.clear();
+                return false;
+            }
         } else {
-            std::cerr << "Dane zostały źle podzielone!\n";
-            exit(EXIT_FAILURE);
+            error = "Dane zostały źle podzielone!";
+            main_list.clear();
+            return false;
         }
         main_list.push_back(new_item);
     }
-    if (counter != list_size) {
-        std::cerr << "Liczba wczytanych zadań nie zgadza się z zadeklarowaną ilośćią!\n";
-        exit(EXIT_FAILURE);
+    if (counter != declared_size) {
+        error = "Liczba wczytanych zadań nie zgadza się z zadeklarowaną ilośćią!";
+        main_list.clear();
+        return false;
     }
-    input_file.close();
+    list_size = declared_size;
+    return true;
+}
+
+template<class Item>
+void Problem<Item>::setItems(const std::vector<Item> &items) {
+    main_list.assign(items.begin(), items.end());
+    list_size = int(main_list.size());
 }
 
 template<class Item>
 int Problem<Item>::workTime(bool count_idle_time) {
     int total_work_time = 0;
-    std::vector<int> post_end_time;
+    int post_end_time = 0;
 
     for (int i = 0; i < this->list_size; i++) {
         if (total_work_time < this->getItem(i).getOccurTime()) {
@@ -58,18 +95,11 @@ int Problem<Item>::workTime(bool count_idle_time) {
 
         }
         total_work_time += this->getItem(i).getWorkTime();
-        post_end_time.push_back(total_work_time + this->getItem(i).getIdleTime());
+        post_end_time = std::max(post_end_time, total_work_time + this->getItem(i).getIdleTime());
     }
 
-    if(count_idle_time){
-        int helper = 0;
-        for (int i = 0; i < int(post_end_time.size()); i++){
-            helper = post_end_time[i] - total_work_time;
-            
-            if(helper > 0){
-                total_work_time += helper;
-            }    
-        }
+    if(count_idle_time && post_end_time > total_work_time){
+        total_work_time = post_end_time;
     }
 
     return total_work_time;
@@ -93,60 +123,134 @@ void Problem<Item>::createOrClearFile(const std::string file_name) {
 }
 
 template<class Item>
-void Problem<Item>::savePermResult(const std::vector<Item> best_order, int best_time, std::string result_file) {
-    std::ofstream output_file(result_file, std::ios::app);
-
-    if (!output_file.is_open()) {
-        std::cerr << "Nie udało się otworzyć pliku do zapisu!" << std::endl;
-        exit(EXIT_FAILURE);
-    }
-
+void Problem<Item>::savePermResult(const std::vector<Item> &best_order, int best_time,
+                                   const std::string &result_file) {
+    saved_line.time = best_time;
+    saved_line.order.clear();
     for (const Item &item: best_order) {
-        output_file << item.getId() << " ";
+        saved_line.order.push_back(item.getId());
     }
 
-    output_file << "  Czas: " << best_time << std::endl;
-    output_file.close();
+    if (saved_results == nullptr || saved_results_name != result_file) {
+        if (saved_results != nullptr) {
+            saved_results->flush();
+        }
+        saved_results.reset();
+        saved_results.reset(new TextSink(result_file, true));
+        saved_results_name = result_file;
+    }
+    saved_results->write(saved_line);
 }
 
 template<class Item>
-void Problem<Item>::displayResult(std::vector<Item> order, int time){
+void Problem<Item>::displayResult(const std::vector<Item> &order, int time){
     std::cout << "Optymalna kolejność wykonywania powyższych zadań jest dla ułożenia: ";
-    for (Item &item: order) {
+    for (const Item &item: order) {
         std::cout << item.getId() << " ";
     }
-    std::cout << std::endl << "Czas potrzebny na wykonanie zadania w powyższej kolejności to: " << time
-              << std::endl;
+    std::cout << "\nCzas potrzebny na wykonanie zadania w powyższej kolejności to: " << time << '\n';
+}
+
+template<class Item>
+void Problem<Item>::reportResult(const char *algorithm, const char *title, const std::vector<Item> &order,
+                                 int time, bool complete) {
+    result.algorithm = algorithm;
+    result.complete = complete;
+    result.order.clear();
+    for (const Item &item: order) {
+        result.order.push_back(item.getId());
+    }
+    result.time = time;
+
+    if (result_sink != nullptr) {
+        result_sink->write(result);
+    }
+    if (verbose) {
+        std::cout << title << '\n';
+        if (time >= 0) {
+            displayResult(order, time);
+        }
+    }
 }
 
 template<class Item>
 void Problem<Item>::permutationSort() {
-    std::string file_destination = ("data/perm_result.txt"); // commented due to unittesting
     //std::vector<Item> orginal = main_list;
     int perm_work_time = 0;
     int best_time;
-    std::vector<Item> best_order;
+    Workspace<Item> &scratch = workspace();
+    WorkspaceLease<Item> lease(scratch, list_size);
+    std::vector<Item> &best_order = scratch.helper;
     bool first_iteration = true;
+    bool stopped = false;
+    uint64_t nodes = 0;
+    int lower_bound = 0;
+    if (solve_control != nullptr) {
+        solve_control->begin();
+        lower_bound = MachineScheduler<Item>::lowerBound(main_list, 1);
+    }
 
-    do {
-        perm_work_time = this->workTime(true);
-        if (first_iteration == true) {
-            best_time = perm_work_time;
-            best_order.assign(main_list.begin(), main_list.end());
-//            this->createOrClearFile(file_destination); // commented due to unittesting
-            first_iteration = false;
-        }
-        if (perm_work_time < best_time) {
-            best_time = perm_work_time;
-            best_order.assign(main_list.begin(), main_list.end());
-        }
+    // Short lists starting from their first permutation go to the solver
+    // specialised for their size, which finds the same order without
+    // visiting every permutation.
+    if (permutation_log == nullptr && list_size > 0 && list_size <= int(TINY_SOLVER_LIMIT) &&
+        std::is_sorted(main_list.begin(), main_list.end())) {
+        best_time = solveTinyInstance(main_list, best_order);
+    } else {
+        ScheduleResult visited;
+        visited.algorithm = "perm";
+        std::vector<Item> &ogrinal = scratch.backup;
+        ogrinal.assign(main_list.begin(), main_list.end());
+        do {
+            perm_work_time = this->workTime(true);
+            if (first_iteration == true) {
+                best_time = perm_work_time;
+                best_order.assign(main_list.begin(), main_list.end());
+                first_iteration = false;
+            }
+            if (perm_work_time < best_time) {
+                best_time = perm_work_time;
+                best_order.assign(main_list.begin(), main_list.end());
+            }
 
-//        this->savePermResult(main_list, perm_work_time, file_destination); // commented due to unittesting
+            if (permutation_log != nullptr) {
+                visited.order.clear();
+                for (const Item &item: main_list) {
+                    visited.order.push_back(item.getId());
+                }
+                visited.time = perm_work_time;
+                permutation_log->write(visited);
+            }
 
-    } while (std::next_permutation(main_list.begin(), main_list.end()));
+            nodes++;
+            if (solve_control != nullptr && solve_control->shouldStop(nodes, best_time, lower_bound)) {
+                stopped = true;
+                break;
+            }
+        } while (std::next_permutation(main_list.begin(), main_list.end()));
+
+        if (stopped) {
+            // The enumeration covered only a corner of the permutations;
+            // the Schrage order may well be better.
+            MachineScheduler<Item> scheduler(1);
+            MachineSchedule schedule;
+            int schrage_time = scheduler.dispatch(ogrinal, schedule);
+            if (schrage_time < best_time) {
+                best_time = schrage_time;
+                best_order.clear();
+                for (int position: schedule.order) {
+                    best_order.push_back(ogrinal[position]);
+                }
+            }
+            main_list.assign(ogrinal.begin(), ogrinal.end());
+        }
+    }
 
-    std::cout << "-------------------------Przegląd zupełny-------------------------" << std::endl;
-    displayResult(best_order, best_time);
+    if (solve_control != nullptr) {
+        solve_control->finish(nodes, best_time, lower_bound);
+    }
+    reportResult("perm", "-------------------------Przegląd zupełny-------------------------", best_order, best_time,
+                 !stopped);
 
     //main_list = orginal;
 }
@@ -157,8 +261,7 @@ void Problem<Item>::occurTimeSort() {
     std::sort(main_list.begin(), main_list.end(), [](const Item &a, const Item &b) { return a.compareByOccurTime(b); });
 
     int best_time = this->workTime(true);
-    std::cout << "------------Algorytm heurystyczny - r (termin dostępności)--------" << std::endl;
-    displayResult(main_list, best_time);
+    reportResult("r", "------------Algorytm heurystyczny - r (termin dostępności)--------", main_list, best_time);
 
     //main_list = orginal;
 }
@@ -169,8 +272,7 @@ void Problem<Item>::idleTimeSort() {
     std::sort(main_list.begin(), main_list.end(), [](const Item &a, const Item &b) { return a.compareByIdleTime(b); });
 
     int best_time = this->workTime(true);
-    std::cout << "------------Algorytm heurystyczny - q (czas stygnięcia)-----------" << std::endl;
-    displayResult(main_list, best_time);
+    reportResult("q", "------------Algorytm heurystyczny - q (czas stygnięcia)-----------", main_list, best_time);
 
     //main_list = orginal;
 }
@@ -191,7 +293,10 @@ void Problem<Item>::eraseChosenVectorElement(std::vector<Item>& list, int serial
 
 template<class Item>
 void Problem<Item>::schrageAlgorithmV1() {
-    std::vector<Item> helper, orginal = main_list;
+    Workspace<Item> &scratch = workspace();
+    WorkspaceLease<Item> lease(scratch, list_size);
+    std::vector<Item> &helper = scratch.helper, &orginal = scratch.backup;
+    orginal.assign(main_list.begin(), main_list.end());
     std::sort(orginal.begin(), orginal.end(), [](const Item &a, const Item &b) { return a.compareByOccurTime(b); });
     main_list.clear();
     main_list.push_back(orginal.front());
@@ -223,22 +328,25 @@ void Problem<Item>::schrageAlgorithmV1() {
     }
 
     int total_work_time = this->workTime(true);
-    std::cout << "----------------Algorytm Schrage - bez wywłaczszeń----------------" << std::endl;
-    displayResult(main_list, total_work_time);
+    reportResult("schrage1", "----------------Algorytm Schrage - bez wywłaczszeń----------------",
+                 main_list, total_work_time);
 }
 
 template<class Item>
 void Problem<Item>::schrageAlgorithmV2() {
-    std::vector<Item> ogrinal = main_list;
+    Workspace<Item> &scratch = workspace();
+    WorkspaceLease<Item> lease(scratch, list_size);
+    std::vector<Item> &ogrinal = scratch.backup;
+    ogrinal.assign(main_list.begin(), main_list.end());
     int orginal_size = list_size;
 
-    std::priority_queue<Item, std::vector<Item>, std::function<bool(const Item&, const Item&)>> idleQueue(
+    ScratchQueue<Item> idleQueue(scratch.first_queue,
         [](const Item &a, const Item &b) { return a.compareByIdleTime(b); });
 
-    std::priority_queue<Item, std::vector<Item>, std::function<bool(const Item&, const Item&)>> helpQueue(
+    ScratchQueue<Item> helpQueue(scratch.second_queue,
         [](const Item &a, const Item &b) { return a.compareByIdleTime(b); });
 
-    std::priority_queue<Item, std::vector<Item>, std::function<bool(const Item&, const Item&)>> occurQueue(
+    ScratchQueue<Item> occurQueue(scratch.third_queue,
         [](const Item &a, const Item &b) { return b.compareByOccurTime(a); });
 
     for (const auto &item : main_list) {
@@ -299,188 +407,241 @@ void Problem<Item>::schrageAlgorithmV2() {
         }
     }
 
+    list_size = main_list.size();
     int total_work_time = this->workTime(true);
-    std::cout << "----------------Algorytm Schrage - bez wywłaczszeń----------------" << std::endl;
-    displayResult(main_list, total_work_time);
-    main_list = ogrinal;
+    reportResult("schrage", "----------------Algorytm Schrage - bez wywłaczszeń----------------",
+                 main_list, total_work_time);
+    main_list.assign(ogrinal.begin(), ogrinal.end());
     list_size = orginal_size;
 }
 
 template<class Item>
 void Problem<Item>::schrageAlgorithmWithExpropriation() {
-    std::vector<Item> ogrinal = main_list;
-    int orginal_size = list_size, last_item_id = 0, current_item_id = 0;
-
-    std::priority_queue<Item, std::vector<Item>, std::function<bool(const Item&, const Item&)>> idleQueue(
-        [](const Item &a, const Item &b) { return a.compareByIdleTime(b); });
+    Workspace<Item> &scratch = workspace();
+    WorkspaceLease<Item> lease(scratch, list_size);
+    std::vector<Item> &ogrinal = scratch.backup;
+    ogrinal.assign(main_list.begin(), main_list.end());
+    int orginal_size = list_size;
 
-    std::priority_queue<Item, std::vector<Item>, std::function<bool(const Item&, const Item&)>> helpQueue(
+    ScratchQueue<Item> idleQueue(scratch.first_queue,
         [](const Item &a, const Item &b) { return a.compareByIdleTime(b); });
 
-    std::priority_queue<Item, std::vector<Item>, std::function<bool(const Item&, const Item&)>> occurQueue(
+    ScratchQueue<Item> occurQueue(scratch.third_queue,
         [](const Item &a, const Item &b) { return b.compareByOccurTime(a); });
 
     for (const auto &item : main_list) {
         occurQueue.push(item);
     }
 
+    // The result lists the parts of the items in the order they run: an
+    // interrupted part keeps only the time it worked and no idle time, the
+    // last part of an item the rest of its work and its idle time. Only an
+    // occurring item interrupts, so there are fewer than twice as many parts
+    // as items.
     main_list.clear();
-    list_size = 1;
-    int current_time = 0;
-
-    Item current_item = occurQueue.top();
-    Item current_item_backup = current_item;
-
-    while (!occurQueue.empty() || !idleQueue.empty()) {
-        if (!idleQueue.empty()){
-            last_item_id = idleQueue.top().getId();
+    main_list.reserve(2 * size_t(orginal_size));
+    int current_time = 0, part_time = 0;
+    bool working = false;
+    Item current_item;
+
+    while (working || !occurQueue.empty() || !idleQueue.empty()) {
+        if (!working && idleQueue.empty()) {
+            current_time = std::max(current_time, occurQueue.top().getOccurTime());
         }
- 
         while (!occurQueue.empty() && occurQueue.top().getOccurTime() <= current_time) {
             idleQueue.push(occurQueue.top());
-            occurQueue.pop(); 
-        }
-        if (!idleQueue.empty()){
-            current_item_id = idleQueue.top().getId();
+            occurQueue.pop();
         }
-        current_time++;
-        
-        if (idleQueue.empty()) {
-            current_time = occurQueue.top().getOccurTime();
-        } 
-        else{
-            if (last_item_id != current_item_id && last_item_id != 0 && current_item_id != 0){
-                Item top_item;
-                while (!idleQueue.empty()) {
-                    if (idleQueue.top().getId() == last_item_id) {
-                        top_item = idleQueue.top();
-                        idleQueue.pop();
-                        break;
-                    }
-                    helpQueue.push(idleQueue.top());
-                    idleQueue.pop();
-                }
-
-                top_item.setWorkTime(current_item.getWorkTime());
-                idleQueue.push(top_item);
-
-                while (!helpQueue.empty()) {
-                    idleQueue.push(helpQueue.top());
-                    helpQueue.pop();
-                }
-
-                current_item.setIdleTime(0);
-                current_item.setWorkTime(current_item_backup.getWorkTime() - current_item.getWorkTime());
-                main_list.push_back(current_item);
-                list_size++;
-                
-                current_item = idleQueue.top(); 
-                current_item_backup = idleQueue.top();
-                current_item.workTimeDecrement();
-
-            }
-            else{
-                if (current_item.getWorkTime() > 0) {
-                    current_item.workTimeDecrement();
 
+        // An item with a longer idle time interrupts the current one.
+        if (working && !idleQueue.empty() && current_item.compareByIdleTime(idleQueue.top())) {
+            Item part = current_item;
+            part.setWorkTime(part_time);
+            part.setIdleTime(0);
+            main_list.push_back(part);
+            idleQueue.push(current_item);
+            working = false;
+        }
+        if (!working) {
+            current_item = idleQueue.top();
+            idleQueue.pop();
+            part_time = 0;
+            working = true;
+        }
 
-                }
-                else { 
-                    current_item.setWorkTime(idleQueue.top().getWorkTime());
-                    main_list.push_back(current_item);
-                    list_size++;
-                    idleQueue.pop();
-                    
-                if(!idleQueue.empty()){
-                    current_item = idleQueue.top(); 
-                    current_item_backup = idleQueue.top();
-                    current_item.workTimeDecrement();
-                }
-                else{
-                    current_item = occurQueue.top();
-                    current_item_backup = occurQueue.top();
-                }
-                }
-            }
+        // Work until the item is done or the next item occurs.
+        int step = current_item.getWorkTime();
+        if (!occurQueue.empty()) {
+            step = std::min(step, occurQueue.top().getOccurTime() - current_time);
+        }
+        current_time += step;
+        part_time += step;
+        current_item.setWorkTime(current_item.getWorkTime() - step);
+        if (current_item.getWorkTime() == 0) {
+            current_item.setWorkTime(part_time);
+            main_list.push_back(current_item);
+            working = false;
         }
     }
 
+    list_size = main_list.size();
     int total_work_time = this->workTime(true);
-    std::cout << "----------------Algorytm Schrage - z wywłaczszeniami--------------" << std::endl;
-    displayResult(main_list, total_work_time);
+    reportResult("schrage-pmtn", "----------------Algorytm Schrage - z wywłaczszeniami--------------",
+                 main_list, total_work_time);
 
     list_size = orginal_size;
-    main_list = ogrinal;
+    main_list.assign(ogrinal.begin(), ogrinal.end());
 }
 
 template<class Item>
 void Problem<Item>::bisoraAlgorithm() {
-    std::vector<Item> ogrinal = main_list;
-    int current_item_occur_time;
+    Workspace<Item> &scratch = workspace();
+    WorkspaceLease<Item> lease(scratch, list_size + 1);
+    std::vector<Item> &ogrinal = scratch.backup;
+    ogrinal.assign(main_list.begin(), main_list.end());
     int orginal_size = list_size;
-    Item temporary, top_item;
 
-    std::priority_queue<Item, std::vector<Item>, std::function<bool(const Item&, const Item&)>> idleQueue(
-        [](const Item &a, const Item &b) { return a.compareByIdleTime(b); });
-
-    std::priority_queue<Item, std::vector<Item>, std::function<bool(const Item&, const Item&)>> helpQueue(
-        [](const Item &a, const Item &b) { return a.compareByIdleTime(b); });
-
-    std::priority_queue<Item, std::vector<Item>, std::function<bool(const Item&, const Item&)>> workQueue(
-        [](const Item &a, const Item &b) { return a.compareByWorkAndOccurTime(b); });
-
-    for (const auto &item : main_list){
-        idleQueue.push(item);
+    // Items in the order they are picked (largest idle time first) and in the
+    // order of their finish time r+p, where an item is found by binary search.
+    std::vector<int> &idle_order = scratch.first_index;
+    std::vector<int> &finish_order = scratch.second_index;
+    std::vector<int> &finish_position = scratch.third_index;
+    // previous[s] is a slot not after s that may still be free (slot 0 is a
+    // sentinel, slot s + 1 holds finish_order[s]); path halving keeps it short.
+    std::vector<int> &previous = scratch.fourth_index;
+
+    for (int i = 0; i < orginal_size; i++) {
+        idle_order.push_back(i);
+        finish_order.push_back(i);
+    }
+    std::sort(idle_order.begin(), idle_order.end(), [&](int a, int b) {
+        if (ogrinal[a].getIdleTime() != ogrinal[b].getIdleTime())
+            return ogrinal[b].compareByIdleTime(ogrinal[a]);
+        return a < b;
+    });
+    std::sort(finish_order.begin(), finish_order.end(), [&](int a, int b) {
+        int finish_a = ogrinal[a].getOccurTime() + ogrinal[a].getWorkTime();
+        int finish_b = ogrinal[b].getOccurTime() + ogrinal[b].getWorkTime();
+        if (finish_a != finish_b)
+            return finish_a < finish_b;
+        return a > b;
+    });
+
+    finish_position.resize(orginal_size);
+    previous.push_back(0);
+    for (int s = 0; s < orginal_size; s++) {
+        finish_position[finish_order[s]] = s;
+        previous.push_back(s + 1);
     }
 
-    main_list.clear();
-    list_size = 0;
+    auto findFree = [&](int slot) {
+        while (previous[slot] != slot) {
+            previous[slot] = previous[previous[slot]];
+            slot = previous[slot];
+        }
+        return slot;
+    };
 
-    while(list_size < orginal_size){
+    main_list.clear();
 
-        current_item_occur_time = idleQueue.top().getOccurTime();
-        temporary = idleQueue.top();
-        idleQueue.pop();
+    for (int index : idle_order) {
+        int slot = finish_position[index] + 1;
+        if (previous[slot] != slot) {
+            continue; // already put in front of an item with larger idle time
+        }
+        previous[slot] = slot - 1;
 
-        int item_total_time;
+        // The item with the latest finish time not after the occur time of the picked one.
+        int current_item_occur_time = ogrinal[index].getOccurTime();
+        auto bound = std::upper_bound(finish_order.begin(), finish_order.end(), current_item_occur_time,
+            [&](int time, int other) { return time < ogrinal[other].getOccurTime() + ogrinal[other].getWorkTime(); });
+        int free_slot = findFree(int(bound - finish_order.begin()));
 
-        while(!idleQueue.empty()){
-            top_item = idleQueue.top();
-            item_total_time = top_item.getOccurTime() + top_item.getWorkTime();
-            if(current_item_occur_time < item_total_time)  
-                helpQueue.push(top_item);
-            else
-                workQueue.push(top_item);    
-            idleQueue.pop();
+        if (free_slot != 0) {
+            previous[free_slot] = free_slot - 1;
+            main_list.push_back(ogrinal[finish_order[free_slot - 1]]);
         }
 
-        if(!workQueue.empty()){
-            top_item = workQueue.top();
-            workQueue.pop();
-            main_list.push_back(top_item);
-        }
+        main_list.push_back(ogrinal[index]);
+    }
 
-        main_list.push_back(temporary);
+    list_size = main_list.size();
+    int total_work_time = this->workTime(true);
+    reportResult("bisora", "-------------------------Algorytm Bisora--------------------------",
+                 main_list, total_work_time);
 
-        while(!workQueue.empty()){
-            idleQueue.push(workQueue.top());
-            workQueue.pop();
-        }
+    list_size = orginal_size;
+    main_list.assign(ogrinal.begin(), ogrinal.end());
+}
 
-        while(!helpQueue.empty()){
-            idleQueue.push(helpQueue.top());
-            helpQueue.pop();
+template<class Item>
+void Problem<Item>::parallelSchrageAlgorithm(int machine_count) {
+    Workspace<Item> &scratch = workspace();
+    WorkspaceLease<Item> lease(scratch, list_size);
+    std::vector<Item> &started = scratch.helper;
+
+    MachineScheduler<Item> scheduler(machine_count);
+    int total_work_time = scheduler.dispatch(main_list, machine_schedule);
+    for (int position: machine_schedule.order) {
+        started.push_back(main_list[position]);
+    }
+    reportResult("schrage-m", "--------------Algorytm Schrage - maszyny równoległe---------------", started,
+                 total_work_time);
+
+    if (verbose) {
+        std::cout << "Maszyny kolejnych zadań: ";
+        for (int position: machine_schedule.order) {
+            std::cout << machine_schedule.machine[position] + 1 << " ";
         }
+        std::cout << '\n';
+    }
+}
 
-        list_size = main_list.size();
+template<class Item>
+void Problem<Item>::subsetDynamicProgramming() {
+    const char *title = "---------------Programowanie dynamiczne (podzbiory)---------------";
+    bool too_large = list_size > int(SUBSET_SOLVER_LIMIT);
+    if (too_large || SubsetSolver<Item>::memoryRequired(size_t(list_size)) > memory_budget) {
+        reportResult("dp", title, std::vector<Item>(), -1, false);
+        if (verbose) {
+            if (too_large) {
+                std::cout << "Zbyt wiele zadań dla programowania dynamicznego (limit: " << SUBSET_SOLVER_LIMIT
+                          << ")!\n";
+            } else {
+                std::cout << "Programowanie dynamiczne potrzebuje "
+                          << (SubsetSolver<Item>::memoryRequired(size_t(list_size)) >> 20)
+                          << " MiB pamięci (limit: " << (memory_budget >> 20) << " MiB)!\n";
+            }
+        }
+        return;
     }
 
-    int total_work_time = this->workTime(true);
-    std::cout << "-------------------------Algorytm Bisora--------------------------" << std::endl;
-    displayResult(main_list, total_work_time);
+    Workspace<Item> &scratch = workspace();
+    WorkspaceLease<Item> lease(scratch, list_size);
+    std::vector<Item> &best_order = scratch.helper;
 
-    list_size = orginal_size;
-    main_list = ogrinal;
+    SubsetSolver<Item> solver(main_list, thread_count);
+    int best_time = solver.solve(best_order, solve_control);
+    reportResult("dp", title, best_order, best_time, solve_control == nullptr || !solve_control->wasStopped());
+}
+
+template<class Item>
+void Problem<Item>::reducedSolve() {
+    Workspace<Item> &scratch = workspace();
+    WorkspaceLease<Item> lease(scratch, list_size);
+    std::vector<Item> &best_order = scratch.helper;
+
+    InstanceReduction<Item> reduction(main_list);
+    bool exact = false;
+    int best_time = reduction.solve(best_order, exact, thread_count, solve_control);
+    reportResult("reduced", "--------------------Redukcja instancji (bloki)--------------------", best_order,
+                 best_time, solve_control == nullptr || !solve_control->wasStopped());
+
+    if (verbose) {
+        std::cout << "Liczba bloków: " << reduction.getBlocks().size()
+                  << ", największy blok: " << reduction.getLargestBlock()
+                  << ", wynik optymalny: " << (exact ? "tak" : "nie (nie udowodniono)") << '\n';
+    }
 }
 
 template<class Item>
@@ -492,9 +653,17 @@ void Problem<Item>::timeMeasure(std::function<void()> callback) {
     auto stop = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(stop - start);
 
-    std::cout << "Powyższy algorytm wykonywał się: " << duration.count() << "ms" 
-              << std::endl << std::endl;
+    std::cout << "Powyższy algorytm wykonywał się: " << duration.count() << "ms\n\n";
+}
+
+
+template<class Item>
+Workspace<Item> &Problem<Item>::workspace() {
+    thread_local Workspace<Item> scratch;
+    return scratch;
 }
 
 
-template class Problem<Item<int>>;
\ No newline at end of file
+template class Problem<Item<int>>;
+template class Problem<Item<short>>;
+template class Problem<SoaJob>;
\ No newline at end of file
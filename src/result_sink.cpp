@@ -0,0 +1,215 @@
+#include "result_sink.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <iostream>
+
+namespace {
+
+/// Size of the buffer behind each file.
+constexpr std::size_t FILE_BUFFER_SIZE = 1 << 20;
+
+/// Longest text of an int: the sign and 10 digits.
+constexpr std::size_t NUMBER_SIZE = 11;
+
+void appendNumber(std::string &line, int value) {
+    char digits[NUMBER_SIZE];
+    auto end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+    line.append(digits, end);
+}
+
+// The IDs separated by the given character. They are written straight into
+// the line, which is grown once for the longest possible text: appending
+// the digits and separators one by one took most of the time of a record.
+void appendNumbers(std::string &line, const std::vector<int> &values, char separator) {
+    std::size_t used = line.size();
+    line.resize(used + values.size() * (NUMBER_SIZE + 1));
+    char *begin = &line[used];
+    char *end = begin;
+    for (size_t i = 0; i < values.size(); i++) {
+        if (i > 0) {
+            *end++ = separator;
+        }
+        end = std::to_chars(end, end + NUMBER_SIZE, values[i]).ptr;
+    }
+    line.resize(used + std::size_t(end - begin));
+}
+
+// A JSON string with quotes, backslashes and control characters escaped.
+void appendJsonString(std::string &line, const std::string &text) {
+    static const char hex_digits[] = "0123456789abcdef";
+    line += '"';
+    for (char character: text) {
+        unsigned char code = static_cast<unsigned char>(character);
+        switch (character) {
+            case '"':
+                line += "\\\"";
+                break;
+            case '\\':
+                line += "\\\\";
+                break;
+            case '\n':
+                line += "\\n";
+                break;
+            case '\r':
+                line += "\\r";
+                break;
+            case '\t':
+                line += "\\t";
+                break;
+            default:
+                if (code < 0x20) {
+                    line += "\\u00";
+                    line += hex_digits[code >> 4];
+                    line += hex_digits[code & 0xf];
+                } else {
+                    line += character;
+                }
+        }
+    }
+    line += '"';
+}
+
+template<class T>
+void appendRaw(std::string &line, T value) {
+    line.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+} // namespace
+
+FileSink::FileSink(const std::string &file_name, bool append, bool binary) : buffer(FILE_BUFFER_SIZE) {
+    std::ios::openmode mode = std::ios::out | (append ? std::ios::app : std::ios::trunc);
+    if (binary) {
+        mode |= std::ios::binary;
+    }
+
+    // The buffer has to be set before the file is opened to take effect.
+    output_file.rdbuf()->pubsetbuf(buffer.data(), std::streamsize(buffer.size()));
+    output_file.open(file_name, mode);
+
+    if (!output_file.is_open()) {
+        std::cerr << "Nie udało się otworzyć pliku do zapisu!\n";
+        exit(EXIT_FAILURE);
+    }
+}
+
+FileSink::~FileSink() {
+    output_file.flush();
+}
+
+void FileSink::flush() {
+    output_file.flush();
+}
+
+TextSink::TextSink(const std::string &file_name, bool append) : FileSink(file_name, append) {}
+
+void TextSink::write(const ScheduleResult &result) {
+    line.clear();
+    appendNumbers(line, result.order, ' ');
+    line += result.order.empty() ? "  Czas: " : "   Czas: ";
+    appendNumber(line, result.time);
+    line += '\n';
+    output_file.write(line.data(), std::streamsize(line.size()));
+}
+
+CsvSink::CsvSink(const std::string &file_name) : FileSink(file_name, false) {
+    output_file << "algorithm,time,order\n";
+}
+
+void CsvSink::write(const ScheduleResult &result) {
+    line.assign(result.algorithm);
+    line += ',';
+    appendNumber(line, result.time);
+    line += ',';
+    appendNumbers(line, result.order, ' ');
+    line += '\n';
+    output_file.write(line.data(), std::streamsize(line.size()));
+}
+
+JsonLinesSink::JsonLinesSink(const std::string &file_name) : FileSink(file_name, false) {}
+
+void JsonLinesSink::write(const ScheduleResult &result) {
+    line.assign("{\"algorithm\":");
+    appendJsonString(line, result.algorithm);
+    line += ",\"time\":";
+    appendNumber(line, result.time);
+    line += ",\"order\":[";
+    appendNumbers(line, result.order, ',');
+    line += "]}\n";
+    output_file.write(line.data(), std::streamsize(line.size()));
+}
+
+BinarySink::BinarySink(const std::string &file_name) : FileSink(file_name, false, true) {}
+
+void BinarySink::write(const ScheduleResult &result) {
+    line.clear();
+    appendRaw(line, uint16_t(result.algorithm.size()));
+    line += result.algorithm;
+    appendRaw(line, int32_t(result.time));
+    appendRaw(line, uint32_t(result.order.size()));
+    for (int id: result.order) {
+        appendRaw(line, int32_t(id));
+    }
+    output_file.write(line.data(), std::streamsize(line.size()));
+}
+
+AsyncSink::AsyncSink(std::unique_ptr<ResultSink> target_s, std::size_t capacity_s)
+    : target(std::move(target_s)), capacity(std::max<std::size_t>(capacity_s, 1)), writing(false), stopping(false),
+      writer(&AsyncSink::work, this) {}
+
+AsyncSink::~AsyncSink() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    changed.notify_all();
+    writer.join();
+    target->flush();
+}
+
+void AsyncSink::write(const ScheduleResult &result) {
+    bool was_empty;
+    {
+        // A producer faster than the file waits for the thread to take the batch.
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this]() { return pending.size() < capacity; });
+        was_empty = pending.empty();
+        pending.push_back(result);
+    }
+    if (was_empty) {
+        changed.notify_all();
+    }
+}
+
+void AsyncSink::flush() {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this]() { return pending.empty() && !writing; });
+    }
+    target->flush();
+}
+
+void AsyncSink::work() {
+    std::vector<ScheduleResult> batch;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            writing = false;
+            changed.notify_all();
+            changed.wait(lock, [this]() { return stopping || !pending.empty(); });
+            if (pending.empty()) {
+                return;
+            }
+            // Swapping keeps the capacity of both batches, so after warming
+            // up neither side allocates for the vector itself.
+            batch.swap(pending);
+            writing = true;
+        }
+        changed.notify_all();
+        for (const ScheduleResult &result: batch) {
+            target->write(result);
+        }
+        batch.clear();
+    }
+}
@@ -0,0 +1,64 @@
+#include "solve_control.h"
+
+#include <algorithm>
+#include <utility>
+
+SolveControl::SolveControl()
+    : token(nullptr), deadline(Clock::time_point::max()), node_limit(UINT64_MAX),
+      report_interval(std::chrono::milliseconds(100)), next_check(0), stopped(false) {}
+
+void SolveControl::setProgressCallback(ProgressCallback progress_s, std::chrono::milliseconds interval) {
+    progress = std::move(progress_s);
+    report_interval = interval;
+}
+
+void SolveControl::begin() {
+    start = Clock::now();
+    next_report = start + report_interval;
+    next_check = std::min(CLOCK_CHECK_NODES, node_limit);
+    stopped = false;
+}
+
+bool SolveControl::check(uint64_t nodes, int incumbent, int lower_bound) {
+    if ((token != nullptr && token->isCancelled()) || nodes >= node_limit) {
+        stopped = true;
+        return true;
+    }
+
+    Clock::time_point now = Clock::now();
+    if (now >= deadline) {
+        stopped = true;
+        return true;
+    }
+    if (progress && now >= next_report) {
+        report(now, nodes, incumbent, lower_bound);
+        next_report = now + report_interval;
+    }
+    // Never step over the node limit, so runs stopped by it are reproducible.
+    next_check = std::min(nodes + CLOCK_CHECK_NODES, node_limit);
+    return false;
+}
+
+void SolveControl::report(Clock::time_point now, uint64_t nodes, int incumbent, int lower_bound) {
+    SolveProgress current;
+    current.incumbent = incumbent;
+    current.lower_bound = lower_bound;
+    current.nodes = nodes;
+    current.seconds = std::chrono::duration<double>(now - start).count();
+    current.nodes_per_second = (current.seconds > 0) ? double(nodes) / current.seconds : 0;
+    progress(current);
+}
+
+void SolveControl::finish(uint64_t nodes, int incumbent, int lower_bound) {
+    if (progress) {
+        report(Clock::now(), nodes, incumbent, lower_bound);
+    }
+}
+
+SolveControl SolveControl::part() const {
+    SolveControl copy;
+    copy.token = token;
+    copy.deadline = deadline;
+    copy.node_limit = node_limit;
+    return copy;
+}
@@ -0,0 +1,193 @@
+#include "solve_service.h"
+#include "item.h"
+#include "problem.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace {
+
+using Algorithm = void (Problem<Item<int>>::*)();
+
+/// An algorithm available to the service.
+struct ServiceAlgorithm {
+    const char *name; ///< Name accepted in SolveRequest::algorithm.
+    Algorithm run; ///< The algorithm.
+    std::size_t item_limit; ///< Largest instance accepted (0 for no limit).
+};
+
+/// Algorithms available to the service, by name.
+const std::vector<ServiceAlgorithm> &algorithmTable() {
+    static const std::vector<ServiceAlgorithm> table = {
+        {"perm", &Problem<Item<int>>::permutationSort, SERVICE_PERMUTATION_LIMIT},
+        {"r", &Problem<Item<int>>::occurTimeSort, 0},
+        {"q", &Problem<Item<int>>::idleTimeSort, 0},
+        {"schrage1", &Problem<Item<int>>::schrageAlgorithmV1, 0},
+        {"schrage", &Problem<Item<int>>::schrageAlgorithmV2, 0},
+        {"schrage-pmtn", &Problem<Item<int>>::schrageAlgorithmWithExpropriation, 0},
+        {"bisora", &Problem<Item<int>>::bisoraAlgorithm, 0},
+        {"dp", &Problem<Item<int>>::subsetDynamicProgramming, 0},
+        {"reduced", &Problem<Item<int>>::reducedSolve, 0},
+    };
+    return table;
+}
+
+const ServiceAlgorithm *findAlgorithm(const std::string &name) {
+    for (const ServiceAlgorithm &entry: algorithmTable()) {
+        if (entry.name == name) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+bool parseRequestHeader(const std::string &line, SolveRequest &request, std::string &error) {
+    std::istringstream words(line);
+    std::string command;
+    long long deadline_ms;
+
+    if (!(words >> command >> request.id >> request.algorithm >> deadline_ms) || command != "SOLVE" ||
+        deadline_ms < 0) {
+        error = "Niepoprawny nagłówek zapytania!";
+        return false;
+    }
+
+    request.deadline = std::chrono::steady_clock::time_point::max();
+    if (deadline_ms > 0) {
+        request.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(deadline_ms);
+    }
+    return true;
+}
+
+std::string formatResponse(const SolveResponse &response) {
+    std::ostringstream line;
+    switch (response.status) {
+        case SolveStatus::Solved:
+        case SolveStatus::Partial:
+            line << (response.status == SolveStatus::Solved ? "RESULT " : "PARTIAL ") << response.id << " "
+                 << response.time;
+            for (int id: response.order) {
+                line << " " << id;
+            }
+            break;
+        case SolveStatus::Expired:
+            line << "EXPIRED " << response.id;
+            break;
+        case SolveStatus::Failed:
+            line << "ERROR " << response.id << " " << response.error;
+            break;
+    }
+    return line.str();
+}
+
+SolveService::SolveService(unsigned worker_count, std::size_t capacity_s)
+    : capacity(std::max<std::size_t>(capacity_s, 1)), stopping(false) {
+    const unsigned hardware_threads = std::max(1u, std::thread::hardware_concurrency());
+    if (worker_count == 0) {
+        worker_count = hardware_threads;
+    }
+    solver_threads = std::max(1u, hardware_threads / worker_count);
+    for (unsigned i = 0; i < worker_count; i++) {
+        workers.emplace_back(&SolveService::work, this);
+    }
+}
+
+SolveService::~SolveService() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    ready.notify_all();
+    for (std::thread &worker: workers) {
+        worker.join();
+    }
+}
+
+void SolveService::submit(SolveRequest request, Callback callback) {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        room.wait(lock, [this]() { return queue.size() < capacity; });
+        queue.emplace_back(std::move(request), std::move(callback));
+    }
+    ready.notify_one();
+}
+
+void SolveService::work() {
+    while (true) {
+        std::pair<SolveRequest, Callback> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            ready.wait(lock, [this]() { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                return;
+            }
+            task = std::move(queue.front());
+            queue.pop_front();
+        }
+        room.notify_one();
+        task.second(solve(task.first, solver_threads));
+    }
+}
+
+SolveResponse SolveService::solve(const SolveRequest &request, unsigned thread_count) {
+    SolveResponse response;
+    response.id = request.id;
+
+    if (std::chrono::steady_clock::now() > request.deadline) {
+        response.status = SolveStatus::Expired;
+        return response;
+    }
+
+    const ServiceAlgorithm *algorithm = findAlgorithm(request.algorithm);
+    if (algorithm == nullptr) {
+        response.error = "Nieznany algorytm: " + request.algorithm + "!";
+        return response;
+    }
+
+    Problem<Item<int>> problem;
+    problem.setVerbose(false);
+    problem.setThreadCount(std::max(1u, thread_count));
+    SolveControl control;
+    control.setDeadline(request.deadline);
+    problem.setSolveControl(&control);
+    std::istringstream instance(request.instance);
+    if (!problem.loadFromStream(instance, response.error)) {
+        return response;
+    }
+    if (problem.getSize() > SERVICE_ITEM_LIMIT) {
+        response.error = "Zbyt wiele zadań (limit: " + std::to_string(SERVICE_ITEM_LIMIT) + ")!";
+        return response;
+    }
+    if (algorithm->item_limit != 0 && problem.getSize() > algorithm->item_limit) {
+        response.error = "Zbyt wiele zadań dla algorytmu " + request.algorithm + " (limit: " +
+                         std::to_string(algorithm->item_limit) + ")!";
+        return response;
+    }
+
+    (problem.*algorithm->run)();
+
+    if (problem.getResultTime() < 0) {
+        response.error = "Algorytm nie zwrócił wyniku!";
+    } else if (!problem.getResult().complete) {
+        response.status = SolveStatus::Partial;
+        response.time = problem.getResultTime();
+        response.order = problem.getResultOrder();
+    } else if (std::chrono::steady_clock::now() > request.deadline) {
+        response.status = SolveStatus::Expired;
+    } else {
+        response.status = SolveStatus::Solved;
+        response.time = problem.getResultTime();
+        response.order = problem.getResultOrder();
+    }
+    return response;
+}
+
+std::vector<std::string> SolveService::algorithms() {
+    std::vector<std::string> names;
+    for (const ServiceAlgorithm &entry: algorithmTable()) {
+        names.push_back(entry.name);
+    }
+    return names;
+}
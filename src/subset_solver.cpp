@@ -0,0 +1,320 @@
+#include "subset_solver.h"
+#include "item.h"
+#include "job.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <climits>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+/// Subsets per thread below which a layer is not split.
+constexpr uint64_t SUBSETS_PER_THREAD = 4096;
+
+} // namespace
+
+/**
+ * @brief Threads kept for a whole solve, each filling its part of a layer.
+ */
+class LayerWorkers {
+private:
+    std::vector<std::thread> threads; /**< Thread i + 1 fills part i + 1; the caller fills part 0. */
+    std::mutex mutex; /**< Guards the job and the counters. */
+    std::condition_variable started; /**< Signals a new job or stopping. */
+    std::condition_variable finished; /**< Signals that every thread is done with the job. */
+    const std::function<void(uint64_t)> *job; /**< The current job, called with the part number. */
+    uint64_t parts; /**< Number of parts of the current job. */
+    uint64_t generation; /**< Number of jobs started so far. */
+    std::size_t running; /**< Threads still busy with the current job. */
+    bool stopping; /**< Whether the threads should end. */
+
+    /**
+     * @brief Main loop of the thread filling the given part of every job.
+     */
+    void work(uint64_t part) {
+        uint64_t seen = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                started.wait(lock, [&]() { return stopping || generation != seen; });
+                if (stopping) {
+                    return;
+                }
+                seen = generation;
+            }
+            if (part < parts) {
+                (*job)(part);
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--running == 0) {
+                finished.notify_one();
+            }
+        }
+    }
+
+public:
+    explicit LayerWorkers(uint64_t count) : job(nullptr), parts(0), generation(0), running(0), stopping(false) {
+        for (uint64_t part = 1; part < count; part++) {
+            threads.emplace_back(&LayerWorkers::work, this, part);
+        }
+    }
+
+    ~LayerWorkers() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        started.notify_all();
+        for (std::thread &thread: threads) {
+            thread.join();
+        }
+    }
+
+    /**
+     * @brief Call the job for every part (at most one more than the number of threads) and wait for all.
+     */
+    void run(uint64_t parts_s, const std::function<void(uint64_t)> &job_s) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &job_s;
+            parts = parts_s;
+            running = threads.size();
+            generation++;
+        }
+        started.notify_all();
+        job_s(0);
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [this]() { return running == 0; });
+    }
+};
+
+template<class Item>
+SubsetSolver<Item>::SubsetSolver(const std::vector<Item> &items_s, unsigned thread_count_s)
+    : items(items_s), thread_count(thread_count_s), control(nullptr), nodes(0), lower(0), upper(0) {
+    assert(items.size() <= SUBSET_SOLVER_LIMIT && "SubsetSolver handles at most SUBSET_SOLVER_LIMIT items");
+    if (thread_count == 0) {
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (const Item &item: items) {
+        times.push_back(Times{item.getOccurTime(), item.getWorkTime(), item.getIdleTime()});
+    }
+
+    std::size_t size = items.size();
+    binomial.assign(size + 1, std::vector<uint64_t>(size + 1, 0));
+    for (std::size_t n = 0; n <= size; n++) {
+        binomial[n][0] = 1;
+        for (std::size_t k = 1; k <= n; k++) {
+            binomial[n][k] = binomial[n - 1][k - 1] + binomial[n - 1][k];
+        }
+    }
+
+    previous_layer.reserve(binomial[size][size / 2]);
+    current_layer.reserve(binomial[size][size / 2]);
+    last_item.assign(std::size_t(1) << size, 0);
+}
+
+template<class Item>
+std::size_t SubsetSolver<Item>::memoryRequired(std::size_t size) {
+    uint64_t widest_layer = 1;
+    for (std::size_t k = 1; k <= size / 2; k++) {
+        widest_layer = widest_layer * (size - k + 1) / k;
+    }
+    return (std::size_t(1) << size) * sizeof(uint8_t) + 2 * widest_layer * sizeof(int) +
+           (size + 1) * (size + 1) * sizeof(uint64_t);
+}
+
+template<class Item>
+bool SubsetSolver<Item>::fillRange(std::size_t size, uint64_t first, uint64_t last, int limit) {
+    // The subset of the given rank: its highest item is the largest p with
+    // binomial[p][size] not above the rank, and so on downwards.
+    uint32_t mask = 0;
+    uint64_t rank = first;
+    for (std::size_t i = size; i > 0; i--) {
+        std::size_t position = i - 1;
+        while (binomial[position + 1][i] <= rank) {
+            position++;
+        }
+        rank -= binomial[position][i];
+        mask |= uint32_t(1) << position;
+    }
+
+    std::array<int, SUBSET_SOLVER_LIMIT> position;
+    std::array<uint64_t, SUBSET_SOLVER_LIMIT + 1> suffix;
+    bool any_finished = false;
+
+    for (rank = first; rank < last; rank++) {
+        std::size_t count = 0;
+        for (std::size_t i = 0; count < size; i++) {
+            if (mask & (uint32_t(1) << i)) {
+                position[count++] = int(i);
+            }
+        }
+
+        // Rank of the subset without its t-th item: the items below keep
+        // their index, the ones above move down by one.
+        suffix[size] = 0;
+        for (std::size_t t = size; t > 0; t--) {
+            suffix[t - 1] = suffix[t] + binomial[position[t - 1]][t - 1];
+        }
+
+        int best_finish = INT_MAX, best_item = 0;
+        uint64_t prefix = 0;
+        for (std::size_t t = 0; t < size; t++) {
+            int start = previous_layer[prefix + suffix[t + 1]];
+            prefix += binomial[position[t]][t + 1];
+            if (start == INT_MAX) {
+                continue;
+            }
+
+            const Times &item = times[position[t]];
+            int finish = std::max(start, item.occur_time) + item.work_time;
+            if (finish + item.idle_time <= limit && finish < best_finish) {
+                best_finish = finish;
+                best_item = position[t];
+            }
+        }
+
+        current_layer[rank] = best_finish;
+        last_item[mask] = uint8_t(best_item);
+        any_finished = any_finished || best_finish != INT_MAX;
+
+        if (rank + 1 < last) {
+            // Next subset with the same number of items (Gosper's hack).
+            uint32_t lowest = mask & (~mask + 1);
+            uint32_t ripple = mask + lowest;
+            mask = (((ripple ^ mask) >> 2) / lowest) | ripple;
+        }
+    }
+
+    return any_finished;
+}
+
+template<class Item>
+bool SubsetSolver<Item>::feasible(int limit, LayerWorkers &workers) {
+    std::size_t size = items.size();
+    previous_layer.assign(1, 0);
+    std::vector<char> finished(thread_count, 0);
+
+    for (std::size_t layer = 1; layer <= size; layer++) {
+        if (control != nullptr && control->shouldStop(nodes, upper, lower)) {
+            return false;
+        }
+        uint64_t layer_size = binomial[size][layer];
+        nodes += layer_size;
+        current_layer.resize(layer_size);
+
+        uint64_t parts = std::min<uint64_t>(thread_count, layer_size / SUBSETS_PER_THREAD + 1);
+        bool any_finished = false;
+        if (parts == 1) {
+            any_finished = fillRange(layer, 0, layer_size, limit);
+        } else {
+            workers.run(parts, [&](uint64_t part) {
+                uint64_t first = layer_size * part / parts, last = layer_size * (part + 1) / parts;
+                finished[part] = fillRange(layer, first, last, limit);
+            });
+            any_finished = std::find(finished.begin(), finished.begin() + long(parts), 1) !=
+                           finished.begin() + long(parts);
+        }
+
+        if (!any_finished) {
+            return false;
+        }
+        std::swap(previous_layer, current_layer);
+    }
+    return true;
+}
+
+template<class Item>
+int SubsetSolver<Item>::readOrder(std::vector<Item> &order) const {
+    order.clear();
+    uint32_t mask = (uint32_t(1) << items.size()) - 1;
+    while (mask != 0) {
+        int item = last_item[mask];
+        order.push_back(items[item]);
+        mask &= ~(uint32_t(1) << item);
+    }
+    std::reverse(order.begin(), order.end());
+
+    int time = 0, total = 0;
+    for (const Item &item: order) {
+        time = std::max(time, item.getOccurTime()) + item.getWorkTime();
+        total = std::max(total, time + item.getIdleTime());
+    }
+    return total;
+}
+
+template<class Item>
+int SubsetSolver<Item>::solve(std::vector<Item> &best_order, SolveControl *control_s) {
+    best_order.clear();
+    std::size_t size = items.size();
+    if (size == 0) {
+        return 0;
+    }
+    control = control_s;
+    nodes = 0;
+    if (control != nullptr) {
+        control->begin();
+    }
+
+    // Every item alone gives a lower bound, the Schrage order an upper one.
+    lower = 0;
+    for (const Item &item: items) {
+        lower = std::max(lower, item.getOccurTime() + item.getWorkTime() + item.getIdleTime());
+    }
+    upper = 0;
+    int time = 0;
+    uint32_t used = 0;
+    for (std::size_t placed = 0; placed < size; placed++) {
+        int earliest = INT_MAX;
+        for (std::size_t i = 0; i < size; i++) {
+            if (!(used & (uint32_t(1) << i))) {
+                earliest = std::min(earliest, items[i].getOccurTime());
+            }
+        }
+        time = std::max(time, earliest);
+        std::size_t chosen = size;
+        for (std::size_t i = 0; i < size; i++) {
+            if (!(used & (uint32_t(1) << i)) && items[i].getOccurTime() <= time &&
+                (chosen == size || items[chosen].compareByIdleTime(items[i]))) {
+                chosen = i;
+            }
+        }
+        used |= uint32_t(1) << chosen;
+        best_order.push_back(items[chosen]);
+        time += items[chosen].getWorkTime();
+        upper = std::max(upper, time + items[chosen].getIdleTime());
+    }
+
+    // The order found by a successful check may be better than the
+    // candidate time, which narrows the search further. The threads are
+    // only started if the widest layer is split at all.
+    LayerWorkers workers(std::min<uint64_t>(thread_count, binomial[size][size / 2] / SUBSETS_PER_THREAD + 1));
+    std::vector<Item> found;
+    while (lower < upper) {
+        int middle = lower + (upper - lower) / 2;
+        if (feasible(middle, workers)) {
+            upper = readOrder(found);
+            best_order.swap(found);
+        } else if (control != nullptr && control->wasStopped()) {
+            break;
+        } else {
+            lower = middle + 1;
+        }
+    }
+
+    if (control != nullptr) {
+        control->finish(nodes, upper, lower);
+        control = nullptr;
+    }
+    return upper;
+}
+
+
+template class SubsetSolver<Item<int>>;
+template class SubsetSolver<Item<short>>;
+template class SubsetSolver<SoaJob>;
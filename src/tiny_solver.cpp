@@ -0,0 +1,127 @@
+#include "tiny_solver.h"
+#include "item.h"
+#include "job.h"
+
+#include <algorithm>
+#include <climits>
+#include <utility>
+
+template<std::size_t N>
+TinySolver<N>::TinySolver(const std::array<int, N> &occur_time_s, const std::array<int, N> &work_time_s,
+                          const std::array<int, N> &idle_time_s)
+    : occur_time(occur_time_s), work_time(work_time_s), idle_time(idle_time_s), current_order(), best_order(),
+      best_time(INT_MAX) {}
+
+template<std::size_t N>
+template<std::size_t Depth>
+void TinySolver<N>::branch(unsigned used, int time, int total) {
+    if constexpr (Depth == N) {
+        if (total < best_time) {
+            best_time = total;
+            best_order = current_order;
+        }
+    } else {
+        // Lower bound of every completion of this branch: each remaining item
+        // finishes no earlier than alone, and the last one no earlier than
+        // after all remaining work.
+        int bound = total, earliest_start = INT_MAX, remaining_work = 0, smallest_idle = INT_MAX;
+        for (std::size_t i = 0; i < N; i++) {
+            if (used & (1u << i)) {
+                continue;
+            }
+            int start = std::max(time, occur_time[i]);
+            bound = std::max(bound, start + work_time[i] + idle_time[i]);
+            earliest_start = std::min(earliest_start, start);
+            remaining_work += work_time[i];
+            smallest_idle = std::min(smallest_idle, idle_time[i]);
+        }
+        bound = std::max(bound, earliest_start + remaining_work + smallest_idle);
+        if (bound >= best_time) {
+            return;
+        }
+
+        for (std::size_t i = 0; i < N; i++) {
+            if (used & (1u << i)) {
+                continue;
+            }
+            int end = std::max(time, occur_time[i]) + work_time[i];
+            current_order[Depth] = int(i);
+            branch<Depth + 1>(used | (1u << i), end, std::max(total, end + idle_time[i]));
+        }
+    }
+}
+
+template<std::size_t N>
+int TinySolver<N>::solve(std::array<int, N> &order) {
+    // Start from the Schrage order as the incumbent bound. It is only a bound:
+    // a branch reaching the same time is still explored, so the returned order
+    // does not depend on it.
+    unsigned used = 0;
+    int time = 0, total = 0;
+    for (std::size_t placed = 0; placed < N; placed++) {
+        int earliest = INT_MAX;
+        for (std::size_t i = 0; i < N; i++) {
+            if (!(used & (1u << i))) {
+                earliest = std::min(earliest, occur_time[i]);
+            }
+        }
+        time = std::max(time, earliest);
+        std::size_t chosen = N;
+        for (std::size_t i = 0; i < N; i++) {
+            if (!(used & (1u << i)) && occur_time[i] <= time && (chosen == N || idle_time[i] > idle_time[chosen])) {
+                chosen = i;
+            }
+        }
+        used |= 1u << chosen;
+        time += work_time[chosen];
+        total = std::max(total, time + idle_time[chosen]);
+    }
+
+    best_time = total + 1;
+    branch<0>(0u, 0, 0);
+    order = best_order;
+    return best_time;
+}
+
+namespace {
+
+template<class Item>
+using TinyEntry = int (*)(const std::vector<Item> &, std::vector<Item> &);
+
+template<class Item, std::size_t N>
+int solveFixed(const std::vector<Item> &list, std::vector<Item> &best_order) {
+    std::array<int, N> occur_time{}, work_time{}, idle_time{}, order{};
+    for (std::size_t i = 0; i < N; i++) {
+        occur_time[i] = list[i].getOccurTime();
+        work_time[i] = list[i].getWorkTime();
+        idle_time[i] = list[i].getIdleTime();
+    }
+
+    TinySolver<N> solver(occur_time, work_time, idle_time);
+    int best_time = solver.solve(order);
+
+    best_order.clear();
+    for (int position: order) {
+        best_order.push_back(list[position]);
+    }
+    return best_time;
+}
+
+template<class Item, std::size_t... Sizes>
+constexpr std::array<TinyEntry<Item>, sizeof...(Sizes)> makeTinyTable(std::index_sequence<Sizes...>) {
+    return {{&solveFixed<Item, Sizes>...}};
+}
+
+} // namespace
+
+template<class Item>
+int solveTinyInstance(const std::vector<Item> &list, std::vector<Item> &best_order) {
+    static constexpr std::array<TinyEntry<Item>, TINY_SOLVER_LIMIT + 1> table =
+        makeTinyTable<Item>(std::make_index_sequence<TINY_SOLVER_LIMIT + 1>());
+    return table[list.size()](list, best_order);
+}
+
+
+template int solveTinyInstance<Item<int>>(const std::vector<Item<int>> &, std::vector<Item<int>> &);
+template int solveTinyInstance<Item<short>>(const std::vector<Item<short>> &, std::vector<Item<short>> &);
+template int solveTinyInstance<SoaJob>(const std::vector<SoaJob> &, std::vector<SoaJob> &);
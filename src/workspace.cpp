@@ -0,0 +1,42 @@
+#include "workspace.h"
+#include "item.h"
+#include "job.h"
+
+template<class Item>
+Workspace<Item>::Workspace() : allocation_count(0), borrowed(false) {}
+
+template<class Item>
+void Workspace<Item>::reserve(size_t size) {
+    for (std::vector<Item> *buffer: {&backup, &helper, &first_queue, &second_queue, &third_queue}) {
+        buffer->clear();
+        if (buffer->capacity() < size) {
+            buffer->reserve(size);
+            allocation_count++;
+        }
+    }
+    for (std::vector<int> *buffer: {&first_index, &second_index, &third_index, &fourth_index}) {
+        buffer->clear();
+        if (buffer->capacity() < size) {
+            buffer->reserve(size);
+            allocation_count++;
+        }
+    }
+}
+
+template<class Item>
+void Workspace<Item>::reset() {
+    backup.clear();
+    helper.clear();
+    first_queue.clear();
+    second_queue.clear();
+    third_queue.clear();
+    first_index.clear();
+    second_index.clear();
+    third_index.clear();
+    fourth_index.clear();
+}
+
+
+template class Workspace<Item<int>>;
+template class Workspace<Item<short>>;
+template class Workspace<SoaJob>;
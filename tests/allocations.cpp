@@ -0,0 +1,66 @@
+#include "doctest/doctest.h"
+#include "item.h"
+#include "problem.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Every operator new of the test runner is counted, so the tests below see
+// all allocations of an algorithm, not only the growth of its workspace.
+
+namespace {
+
+std::atomic<std::size_t> allocation_count(0);
+
+} // namespace
+
+void *operator new(std::size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void *memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept { std::free(memory); }
+
+void operator delete(void *memory, std::size_t) noexcept { std::free(memory); }
+
+TEST_CASE("Workspace reuse") {
+    Problem<Item<int>> problem;
+    CHECK_NOTHROW(problem.loadFromFile("../data/test_data.txt"));
+    problem.setVerbose(false);
+
+    auto solveAll = [&]() {
+        problem.schrageAlgorithmV1();
+        problem.schrageAlgorithmV2();
+        problem.schrageAlgorithmWithExpropriation();
+        problem.bisoraAlgorithm();
+    };
+
+    SUBCASE("Repeated solves do not allocate") {
+        std::size_t before = allocation_count.load();
+        std::vector<int> probe(problem.getSize());
+        CHECK(allocation_count.load() == before + 1);
+
+        // The first run sizes the workspace, the list and the result.
+        solveAll();
+        std::size_t allocations = allocation_count.load();
+        for (int i = 0; i < 3; i++) {
+            solveAll();
+        }
+        CHECK(allocation_count.load() == allocations);
+        CHECK(problem.getResultTime() == 32);
+    }
+
+    SUBCASE("The workspace is given back after every algorithm") {
+        problem.bisoraAlgorithm();
+        CHECK_FALSE(Problem<Item<int>>::workspace().isBorrowed());
+        {
+            WorkspaceLease<Item<int>> lease(Problem<Item<int>>::workspace(), 4);
+            CHECK(Problem<Item<int>>::workspace().isBorrowed());
+        }
+        CHECK_FALSE(Problem<Item<int>>::workspace().isBorrowed());
+    }
+}
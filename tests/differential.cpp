@@ -0,0 +1,711 @@
+// Differential tests of the scheduling algorithms on random instances.
+//
+// Every instance is solved by all algorithms and the results are compared
+// with simple reference implementations written here:
+// - exhaustive search over all orders (up to EXHAUSTIVE_LIMIT items) against
+//   the tiny solver, the subset DP, permutationSort and the exact blocks of
+//   the instance reduction,
+// - a plain O(n^2) Schrage against MachineScheduler on one machine and
+//   IncrementalSchedule (same rule: the largest idle time among the items
+//   that occurred, then the lowest ID), the latter also after random batches
+//   of added, removed and changed items,
+// - a unit-step preemptive Schrage against schrageAlgorithmWithExpropriation,
+// - copies of schrageAlgorithmV1 and bisoraAlgorithm as they were before the
+//   workspace and index rewrites against the current ones (Bisora only on
+//   instances without equal idle times and without equal r+p, where the
+//   rewrite promises the same order),
+// - every reported total time against the time of the reported order, and
+//   no total time below the lower bound (or the optimum, when it is known),
+// - no order the critical path proves optimal above the exhaustive optimum.
+//
+// The solvers of Problem, the subset DP and the instance reduction run on
+// the items stored as Item<int>, Item<short> and SoaJob, the last two with
+// the subset DP and the reduction split between several threads.
+//
+// Instances are checked on several threads. A failing instance is shrunk
+// (items removed, times lowered) while it still fails, and written in the
+// data/ format so it can be loaded by main.
+
+#ifdef ENABLE_DOCTEST_IN_LIBRARY
+#define DOCTEST_CONFIG_IMPLEMENT
+#include "doctest/doctest.h"
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "critical_path.h"
+#include "generator.h"
+#include "incremental_schedule.h"
+#include "item.h"
+#include "job.h"
+#include "multi_machine.h"
+#include "preprocessing.h"
+#include "problem.h"
+#include "subset_solver.h"
+#include "tiny_solver.h"
+
+using Job = Item<int>;
+
+const size_t EXHAUSTIVE_LIMIT = 8; // Largest instance solved by exhaustive search.
+const size_t EXACT_LIMIT = 16; // Largest instance solved by the subset DP.
+const size_t SHRINK_LIMIT = 5; // Number of failures shrunk and written.
+
+// Total time of the items in the given order (positions in the list).
+static int evaluate(const std::vector<Job> &items, const std::vector<int> &order) {
+    int time = 0, total = 0;
+    for (int position: order) {
+        const Job &item = items[size_t(position)];
+        time = std::max(time, item.getOccurTime()) + item.getWorkTime();
+        total = std::max(total, time + item.getIdleTime());
+    }
+    return total;
+}
+
+// Total time of the items with the given IDs in this order (IDs are positions + 1).
+static int evaluateIds(const std::vector<Job> &items, const std::vector<int> &ids) {
+    std::vector<int> order;
+    for (int id: ids) {
+        if (id < 1 || size_t(id) > items.size()) {
+            return -1;
+        }
+        order.push_back(id - 1);
+    }
+    std::vector<int> sorted = order;
+    std::sort(sorted.begin(), sorted.end());
+    if (sorted.size() != items.size() || std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end()) {
+        return -1; // not a permutation of the items
+    }
+    return evaluate(items, order);
+}
+
+static int exhaustiveSearch(const std::vector<Job> &items) {
+    std::vector<int> order(items.size());
+    std::iota(order.begin(), order.end(), 0);
+    int best = INT_MAX;
+    do {
+        best = std::min(best, evaluate(items, order));
+    } while (std::next_permutation(order.begin(), order.end()));
+    return best;
+}
+
+// Schrage without expropriation: start the waiting item with the largest
+// idle time (then the lowest position), or wait for the next item. Returns
+// the positions in the order they start.
+static std::vector<int> referenceSchrageOrder(const std::vector<Job> &items) {
+    std::vector<bool> done(items.size(), false);
+    std::vector<int> order;
+    int time = 0;
+    while (order.size() < items.size()) {
+        int chosen = -1, next_occur = INT_MAX;
+        for (size_t i = 0; i < items.size(); i++) {
+            if (done[i]) {
+                continue;
+            }
+            if (items[i].getOccurTime() <= time) {
+                if (chosen < 0 || items[i].getIdleTime() > items[size_t(chosen)].getIdleTime()) {
+                    chosen = int(i);
+                }
+            } else {
+                next_occur = std::min(next_occur, items[i].getOccurTime());
+            }
+        }
+        if (chosen < 0) {
+            time = next_occur;
+            continue;
+        }
+        done[size_t(chosen)] = true;
+        order.push_back(chosen);
+        time += items[size_t(chosen)].getWorkTime();
+    }
+    return order;
+}
+
+static int referenceSchrage(const std::vector<Job> &items) {
+    return evaluate(items, referenceSchrageOrder(items));
+}
+
+// Problem::workTime as it was before the rewrites: the finish time of the
+// first count items, or their total time.
+static int baselineWorkTime(const std::vector<Job> &list, size_t count, bool count_idle_time) {
+    int total_work_time = 0;
+    std::vector<int> post_end_time;
+    for (size_t i = 0; i < count; i++) {
+        if (total_work_time < list[i].getOccurTime()) {
+            total_work_time += (list[i].getOccurTime() - total_work_time);
+        }
+        total_work_time += list[i].getWorkTime();
+        post_end_time.push_back(total_work_time + list[i].getIdleTime());
+    }
+    if (count_idle_time) {
+        for (int end_time: post_end_time) {
+            if (end_time - total_work_time > 0) {
+                total_work_time += end_time - total_work_time;
+            }
+        }
+    }
+    return total_work_time;
+}
+
+// Problem::schrageAlgorithmV1 as it was before the rewrites.
+static int baselineSchrageV1(const std::vector<Job> &items) {
+    std::vector<Job> helper, orginal = items, main_list;
+    std::sort(orginal.begin(), orginal.end(), [](const Job &a, const Job &b) { return a.compareByOccurTime(b); });
+    main_list.push_back(orginal.front());
+    orginal.erase(orginal.begin());
+    int current_work_time = baselineWorkTime(main_list, main_list.size(), false);
+
+    while (!orginal.empty()) {
+        for (const auto &item: orginal) {
+            if (item.getOccurTime() < current_work_time) {
+                helper.push_back(item);
+            }
+        }
+
+        if (!helper.empty()) {
+            std::sort(helper.begin(), helper.end(), [](const Job &a, const Job &b) { return a.compareByIdleTime(b); });
+            main_list.push_back(helper.back());
+            int num_to_erase = helper.back().getId();
+            orginal.erase(std::find_if(orginal.begin(), orginal.end(),
+                                       [&](const Job &item) { return item.getId() == num_to_erase; }));
+        } else {
+            main_list.push_back(orginal.front());
+            orginal.erase(orginal.begin());
+        }
+
+        helper.clear();
+        current_work_time = baselineWorkTime(main_list, main_list.size(), false);
+    }
+    return baselineWorkTime(main_list, main_list.size(), true);
+}
+
+// Problem::bisoraAlgorithm as it was before the rewrites, with its three heaps.
+static int baselineBisora(const std::vector<Job> &items) {
+    using Queue = std::priority_queue<Job, std::vector<Job>, std::function<bool(const Job &, const Job &)>>;
+    Queue idleQueue([](const Job &a, const Job &b) { return a.compareByIdleTime(b); });
+    Queue helpQueue([](const Job &a, const Job &b) { return a.compareByIdleTime(b); });
+    Queue workQueue([](const Job &a, const Job &b) { return a.compareByWorkAndOccurTime(b); });
+    std::vector<Job> main_list;
+
+    for (const auto &item: items) {
+        idleQueue.push(item);
+    }
+
+    while (main_list.size() < items.size()) {
+        int current_item_occur_time = idleQueue.top().getOccurTime();
+        Job temporary = idleQueue.top();
+        idleQueue.pop();
+
+        while (!idleQueue.empty()) {
+            Job top_item = idleQueue.top();
+            int item_total_time = top_item.getOccurTime() + top_item.getWorkTime();
+            if (current_item_occur_time < item_total_time)
+                helpQueue.push(top_item);
+            else
+                workQueue.push(top_item);
+            idleQueue.pop();
+        }
+
+        if (!workQueue.empty()) {
+            main_list.push_back(workQueue.top());
+            workQueue.pop();
+        }
+
+        main_list.push_back(temporary);
+
+        while (!workQueue.empty()) {
+            idleQueue.push(workQueue.top());
+            workQueue.pop();
+        }
+
+        while (!helpQueue.empty()) {
+            idleQueue.push(helpQueue.top());
+            helpQueue.pop();
+        }
+    }
+    return baselineWorkTime(main_list, main_list.size(), true);
+}
+
+// Whether no two items share an idle time or an r+p, the keys Bisora orders by.
+static bool withoutBisoraTies(const std::vector<Job> &items) {
+    std::vector<int> idle_times, finish_times;
+    for (const Job &item: items) {
+        idle_times.push_back(item.getIdleTime());
+        finish_times.push_back(item.getOccurTime() + item.getWorkTime());
+    }
+    for (std::vector<int> *keys: {&idle_times, &finish_times}) {
+        std::sort(keys->begin(), keys->end());
+        if (std::adjacent_find(keys->begin(), keys->end()) != keys->end()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Schrage with expropriation, one time unit at a time: the waiting item
+// with the largest idle time works for a unit.
+static int referencePreemptiveSchrage(const std::vector<Job> &items) {
+    std::vector<int> left(items.size());
+    size_t finished = 0;
+    for (size_t i = 0; i < items.size(); i++) {
+        left[i] = items[i].getWorkTime();
+        finished += (left[i] == 0) ? 1 : 0;
+    }
+    int time = 0, total = 0;
+    for (size_t i = 0; i < items.size(); i++) {
+        if (left[i] == 0) {
+            total = std::max(total, items[i].getOccurTime() + items[i].getIdleTime());
+        }
+    }
+    while (finished < items.size()) {
+        int chosen = -1, next_occur = INT_MAX;
+        for (size_t i = 0; i < items.size(); i++) {
+            if (left[i] == 0) {
+                continue;
+            }
+            if (items[i].getOccurTime() <= time) {
+                if (chosen < 0 || items[i].getIdleTime() > items[size_t(chosen)].getIdleTime()) {
+                    chosen = int(i);
+                }
+            } else {
+                next_occur = std::min(next_occur, items[i].getOccurTime());
+            }
+        }
+        if (chosen < 0) {
+            time = next_occur;
+            continue;
+        }
+        time++;
+        if (--left[size_t(chosen)] == 0) {
+            finished++;
+            total = std::max(total, time + items[size_t(chosen)].getIdleTime());
+        }
+    }
+    return total;
+}
+
+// Results of the reference implementations for one instance.
+struct Expected {
+    int lower_bound = 0; // Lower bound of the total time.
+    int optimum = -1; // Optimal total time (-1 if not known).
+    bool exhaustive = false; // Whether the optimum comes from exhaustive search.
+    int preemptive = 0; // Total time of the unit-step preemptive Schrage.
+    int schrage_v1 = -1; // Total time of the baseline schrageAlgorithmV1.
+    int bisora = -1; // Total time of the baseline bisoraAlgorithm (-1 if the instance has ties).
+};
+
+static std::string describe(const std::string &what, int got, int expected) {
+    return what + ": " + std::to_string(got) + ", oczekiwano " + std::to_string(expected);
+}
+
+// The items in another layout, with the same IDs and times.
+template<class Layout>
+static std::vector<Layout> convert(const std::vector<Job> &items) {
+    std::vector<Layout> converted;
+    for (const Job &item: items) {
+        converted.emplace_back(item.getId(), item.getOccurTime(), item.getWorkTime(), item.getIdleTime());
+    }
+    return converted;
+}
+
+template<class Layout>
+static std::vector<int> idsOf(const std::vector<Layout> &order) {
+    std::vector<int> ids;
+    for (const Layout &item: order) {
+        ids.push_back(item.getId());
+    }
+    return ids;
+}
+
+// An order the critical path proves optimal must have the optimal time; only
+// checked when the optimum comes from exhaustive search.
+static std::string checkProof(const std::vector<Job> &items, const std::vector<int> &ids, const std::string &what,
+                              const Expected &expected) {
+    if (!expected.exhaustive || evaluateIds(items, ids) < 0) {
+        return "";
+    }
+    std::vector<Job> order;
+    for (int id: ids) {
+        order.push_back(items[size_t(id - 1)]);
+    }
+    std::vector<int> finish_times;
+    CriticalPath path = analyseCriticalPath(order, finish_times);
+    if (path.isOptimal() && path.time != expected.optimum) {
+        return describe("analyseCriticalPath(" + what + ") dowodzi optymalności", path.time, expected.optimum);
+    }
+    return "";
+}
+
+// Checks the algorithms on the items stored in the given layout, with the
+// solvers split between the given number of threads. Sets the optimum when
+// the subset DP finds it first.
+template<class Layout>
+static std::string checkLayout(const std::vector<Job> &items, Expected &expected, unsigned thread_count,
+                               const std::string &layout) {
+    const size_t n = items.size();
+    const std::vector<Layout> converted = convert<Layout>(items);
+    const std::string prefix = layout.empty() ? "" : layout + " ";
+
+    if (n <= EXACT_LIMIT) {
+        std::vector<Layout> order;
+        SubsetSolver<Layout> solver(converted, thread_count);
+        int exact = solver.solve(order);
+        std::vector<int> ids = idsOf(order);
+        if (expected.optimum >= 0 && exact != expected.optimum) {
+            return describe(prefix + "SubsetSolver", exact, expected.optimum);
+        }
+        if (evaluateIds(items, ids) != exact) {
+            return describe(prefix + "SubsetSolver - czas kolejności", evaluateIds(items, ids), exact);
+        }
+        expected.optimum = exact;
+    }
+
+    InstanceReduction<Layout> reduction(converted, EXACT_LIMIT);
+    std::vector<Layout> reduced_order;
+    bool exact = false;
+    int reduced = reduction.solve(reduced_order, exact, thread_count);
+    std::vector<int> reduced_ids = idsOf(reduced_order);
+    if (evaluateIds(items, reduced_ids) != reduced) {
+        return describe(prefix + "InstanceReduction - czas kolejności", evaluateIds(items, reduced_ids), reduced);
+    }
+    if (exact && expected.optimum >= 0 && reduced != expected.optimum) {
+        return describe(prefix + "InstanceReduction (dokładny)", reduced, expected.optimum);
+    }
+
+    // Algorithms of Problem: the reported time is the time of the reported order
+    // and never below the lower bound or the optimum.
+    // An algorithm with a baseline copy must also match its time.
+    struct Algorithm {
+        const char *name;
+        void (Problem<Layout>::*run)();
+        bool exact;
+        int Expected::*baseline;
+    };
+    const Algorithm algorithms[] = {
+        {"permutationSort", &Problem<Layout>::permutationSort, true, nullptr},
+        {"occurTimeSort", &Problem<Layout>::occurTimeSort, false, nullptr},
+        {"idleTimeSort", &Problem<Layout>::idleTimeSort, false, nullptr},
+        {"schrageAlgorithmV1", &Problem<Layout>::schrageAlgorithmV1, false, &Expected::schrage_v1},
+        {"schrageAlgorithmV2", &Problem<Layout>::schrageAlgorithmV2, false, nullptr},
+        {"bisoraAlgorithm", &Problem<Layout>::bisoraAlgorithm, false, &Expected::bisora},
+        {"subsetDynamicProgramming", &Problem<Layout>::subsetDynamicProgramming, true, nullptr},
+        {"reducedSolve", &Problem<Layout>::reducedSolve, false, nullptr},
+    };
+    Problem<Layout> problem;
+    problem.setVerbose(false);
+    for (const Algorithm &algorithm: algorithms) {
+        if (algorithm.exact &&
+            n > (algorithm.run == &Problem<Layout>::permutationSort ? EXHAUSTIVE_LIMIT : EXACT_LIMIT)) {
+            continue;
+        }
+        problem.setItems(converted);
+        (problem.*algorithm.run)();
+        const std::string name = prefix + algorithm.name;
+        int time = problem.getResultTime();
+        std::vector<int> ids = problem.getResultOrder();
+        if (evaluateIds(items, ids) != time) {
+            return describe(name + " - czas kolejności", evaluateIds(items, ids), time);
+        }
+        if (time < expected.lower_bound) {
+            return describe(name + " poniżej dolnej granicy", time, expected.lower_bound);
+        }
+        if (expected.optimum >= 0 && (algorithm.exact ? time != expected.optimum : time < expected.optimum)) {
+            return describe(name + (algorithm.exact ? "" : " poniżej optimum"), time, expected.optimum);
+        }
+        if (algorithm.baseline != nullptr && expected.*algorithm.baseline >= 0 &&
+            time != expected.*algorithm.baseline) {
+            return describe(name + " inaczej niż przed zmianami", time, expected.*algorithm.baseline);
+        }
+        std::string failure = checkProof(items, ids, name, expected);
+        if (!failure.empty()) {
+            return failure;
+        }
+    }
+
+    problem.setItems(converted);
+    problem.schrageAlgorithmWithExpropriation();
+    if (problem.getResultTime() != expected.preemptive) {
+        return describe(prefix + "schrageAlgorithmWithExpropriation", problem.getResultTime(), expected.preemptive);
+    }
+    return "";
+}
+
+// Applies random batches of added, removed and changed items to the schedule
+// of the instance and compares it with the reference Schrage after each one.
+static std::string checkIncrementalBatches(const std::vector<Job> &items, IncrementalSchedule<Job> &incremental) {
+    const int BATCH_COUNT = 4;
+    int max_occur_time = 0, max_work_time = 1, max_idle_time = 0, next_id = 1;
+    uint32_t seed = uint32_t(items.size());
+    for (const Job &item: items) {
+        max_occur_time = std::max(max_occur_time, item.getOccurTime());
+        max_work_time = std::max(max_work_time, item.getWorkTime());
+        max_idle_time = std::max(max_idle_time, item.getIdleTime());
+        next_id = std::max(next_id, item.getId() + 1);
+        seed = seed * 31 + uint32_t(item.getOccurTime() + item.getWorkTime() + item.getIdleTime());
+    }
+    std::mt19937 random(seed);
+    auto uniform = [&](int low, int high) { return std::uniform_int_distribution<int>(low, high)(random); };
+    auto randomItem = [&](int id) {
+        return Job(id, uniform(0, max_occur_time), uniform(1, max_work_time), uniform(0, max_idle_time));
+    };
+
+    // Kept sorted by ID, so the lowest position breaks ties like the lowest ID.
+    std::vector<Job> current = items;
+    std::sort(current.begin(), current.end());
+    std::vector<Job> scheduled;
+    for (int batch = 0; batch < BATCH_COUNT; batch++) {
+        const std::string name = "IncrementalSchedule po zmianach " + std::to_string(batch + 1);
+        for (int change = uniform(1, 5); change > 0; change--) {
+            int kind = current.empty() ? 0 : uniform(0, 2);
+            if (kind == 0) {
+                current.push_back(randomItem(next_id++));
+                if (!incremental.addItem(current.back())) {
+                    return name + ": addItem odrzucił nowe zadanie";
+                }
+                continue;
+            }
+            size_t at = size_t(uniform(0, int(current.size()) - 1));
+            if (kind == 1) {
+                if (!incremental.removeItem(current[at].getId())) {
+                    return name + ": removeItem nie znalazł zadania";
+                }
+                current.erase(current.begin() + long(at));
+            } else {
+                current[at] = randomItem(current[at].getId());
+                if (!incremental.updateItem(current[at])) {
+                    return name + ": updateItem nie znalazł zadania";
+                }
+            }
+        }
+
+        std::vector<int> order = referenceSchrageOrder(current);
+        int reference = evaluate(current, order);
+        if (incremental.getTime() != reference) {
+            return describe(name, incremental.getTime(), reference);
+        }
+        incremental.getOrder(scheduled);
+        if (scheduled.size() != order.size()) {
+            return describe(name + " - liczba zadań", int(scheduled.size()), int(order.size()));
+        }
+        for (size_t i = 0; i < order.size(); i++) {
+            if (scheduled[i].getId() != current[size_t(order[i])].getId()) {
+                return describe(name + " - zadanie na pozycji " + std::to_string(i), scheduled[i].getId(),
+                                current[size_t(order[i])].getId());
+            }
+        }
+    }
+    return "";
+}
+
+// Checks one instance; returns the description of the first difference found (empty if none).
+static std::string check(const std::vector<Job> &items) {
+    const size_t n = items.size();
+    Expected expected;
+    expected.lower_bound = MachineScheduler<Job>::lowerBound(items, 1);
+
+    if (n <= EXHAUSTIVE_LIMIT) {
+        expected.optimum = exhaustiveSearch(items);
+        expected.exhaustive = true;
+        if (expected.optimum < expected.lower_bound) {
+            return describe("dolna granica powyżej optimum", expected.lower_bound, expected.optimum);
+        }
+        std::vector<Job> order;
+        int tiny = solveTinyInstance(items, order);
+        if (tiny != expected.optimum) {
+            return describe("solveTinyInstance", tiny, expected.optimum);
+        }
+    }
+
+    int reference = referenceSchrage(items);
+    MachineScheduler<Job> scheduler(1);
+    MachineSchedule schedule;
+    int dispatched = scheduler.dispatch(items, schedule);
+    if (dispatched != reference) {
+        return describe("MachineScheduler(1)", dispatched, reference);
+    }
+    if (scheduler.evaluate(items, schedule) != evaluate(items, schedule.order)) {
+        return describe("MachineScheduler::evaluate", scheduler.evaluate(items, schedule),
+                        evaluate(items, schedule.order));
+    }
+    std::vector<int> schrage_ids;
+    for (int position: schedule.order) {
+        schrage_ids.push_back(items[size_t(position)].getId());
+    }
+    std::string failure = checkProof(items, schrage_ids, "MachineScheduler(1)", expected);
+    if (!failure.empty()) {
+        return failure;
+    }
+    IncrementalSchedule<Job> incremental(items);
+    if (incremental.getTime() != reference) {
+        return describe("IncrementalSchedule", incremental.getTime(), reference);
+    }
+    failure = checkIncrementalBatches(items, incremental);
+    if (!failure.empty()) {
+        return failure;
+    }
+
+    for (int machine_count: {2, 3, 7}) {
+        MachineScheduler<Job> parallel(machine_count);
+        int time = parallel.dispatch(items, schedule);
+        int bound = MachineScheduler<Job>::lowerBound(items, machine_count);
+        const std::string name = "MachineScheduler(" + std::to_string(machine_count) + ")";
+        if (time < bound) {
+            return describe(name + " poniżej dolnej granicy", time, bound);
+        }
+        if (time != parallel.evaluate(items, schedule)) {
+            return describe(name + "::evaluate", parallel.evaluate(items, schedule), time);
+        }
+    }
+
+    if (!items.empty()) {
+        expected.schrage_v1 = baselineSchrageV1(items);
+    }
+    if (withoutBisoraTies(items)) {
+        expected.bisora = baselineBisora(items);
+    }
+    expected.preemptive = referencePreemptiveSchrage(items);
+    if (expected.optimum >= 0 && expected.preemptive > expected.optimum) {
+        return describe("Schrage z wywłaszczeniami powyżej optimum", expected.preemptive, expected.optimum);
+    }
+
+    // Every layout; the compact ones with the solvers on several threads,
+    // where SoaJob items may only be read on the thread that created them.
+    failure = checkLayout<Job>(items, expected, 1, "");
+    if (failure.empty()) {
+        failure = checkLayout<Item<short>>(items, expected, 2, "Item<short>");
+    }
+    if (failure.empty()) {
+        failure = checkLayout<SoaJob>(items, expected, 3, "SoaJob");
+    }
+    SoaJobStore::local().truncate();
+    return failure;
+}
+
+// Random instance for a seed: sizes and time ranges vary, so that some
+// instances split into blocks, some have many equal times.
+static std::vector<Job> makeInstance(uint32_t seed) {
+    const size_t sizes[] = {1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 14, 16, 30, 100, 300};
+    size_t n = sizes[seed % (sizeof(sizes) / sizeof(sizes[0]))];
+    int max_work_time = 1 + int(seed / 15 % 4) * 10;
+    int max_occur_time = (seed % 3 == 0) ? 3 : -1;
+    int max_idle_time = (seed % 5 == 0) ? 2 : -1;
+    return generateInstance<Job>(n, seed, max_work_time, max_occur_time, max_idle_time);
+}
+
+// Removes items and lowers times while the instance still fails.
+static std::vector<Job> shrink(std::vector<Job> items) {
+    auto renumbered = [](std::vector<Job> list) {
+        for (size_t i = 0; i < list.size(); i++) {
+            list[i] = Job(int(i) + 1, list[i].getOccurTime(), list[i].getWorkTime(), list[i].getIdleTime());
+        }
+        return list;
+    };
+
+    bool progress = true;
+    while (progress) {
+        progress = false;
+        for (size_t i = items.size(); i-- > 0 && items.size() > 1;) {
+            std::vector<Job> candidate = items;
+            candidate.erase(candidate.begin() + long(i));
+            candidate = renumbered(candidate);
+            if (!check(candidate).empty()) {
+                items = candidate;
+                progress = true;
+            }
+        }
+        for (size_t i = 0; i < items.size(); i++) {
+            for (int field = 0; field < 3; field++) {
+                int values[] = {items[i].getOccurTime(), items[i].getWorkTime(), items[i].getIdleTime()};
+                int current = values[field];
+                // Work times stay positive, like in generated instances.
+                int smallest = (field == 1) ? 1 : 0;
+                for (int lower: {smallest, current / 2, current - 1}) {
+                    if (lower >= current || lower < smallest) {
+                        continue;
+                    }
+                    values[field] = lower;
+                    std::vector<Job> candidate = items;
+                    candidate[i] = Job(items[i].getId(), values[0], values[1], values[2]);
+                    if (!check(candidate).empty()) {
+                        items = candidate;
+                        progress = true;
+                        break;
+                    }
+                    values[field] = current;
+                }
+            }
+        }
+    }
+    return items;
+}
+
+static bool writeInstance(const std::string &file_name, const std::vector<Job> &items) {
+    std::ofstream file(file_name);
+    file << items.size() << '\n';
+    for (const Job &item: items) {
+        file << item.getOccurTime() << ' ' << item.getWorkTime() << ' ' << item.getIdleTime() << '\n';
+    }
+    return bool(file);
+}
+
+int main(int argc, char *argv[]) {
+    if (argc > 5) {
+        std::cout << "Użycie: " << argv[0] << " [liczba instancji] [liczba wątków] [ziarno] [katalog wyników]"
+                  << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    uint32_t instance_count = (argc > 1) ? uint32_t(std::stoul(argv[1])) : 3000;
+    unsigned thread_count = (argc > 2) ? unsigned(std::stoul(argv[2])) : 0;
+    uint32_t first_seed = (argc > 3) ? uint32_t(std::stoul(argv[3])) : 1;
+    std::string output_dir = (argc > 4) ? argv[4] : ".";
+    if (thread_count == 0) {
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    std::atomic<uint32_t> next(0);
+    std::mutex mutex;
+    std::vector<uint32_t> failed_seeds;
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < thread_count; t++) {
+        workers.emplace_back([&]() {
+            for (uint32_t index = next++; index < instance_count; index = next++) {
+                uint32_t seed = first_seed + index;
+                std::string failure = check(makeInstance(seed));
+                if (!failure.empty()) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    std::cout << "Ziarno " << seed << ": " << failure << std::endl;
+                    failed_seeds.push_back(seed);
+                }
+            }
+        });
+    }
+    for (std::thread &worker: workers) {
+        worker.join();
+    }
+
+    std::sort(failed_seeds.begin(), failed_seeds.end());
+    for (size_t i = 0; i < failed_seeds.size() && i < SHRINK_LIMIT; i++) {
+        std::vector<Job> smallest = shrink(makeInstance(failed_seeds[i]));
+        std::string file_name = output_dir + "/differential_" + std::to_string(failed_seeds[i]) + ".txt";
+        if (writeInstance(file_name, smallest)) {
+            std::cout << "Ziarno " << failed_seeds[i] << " po zmniejszeniu (" << smallest.size()
+                      << " zadań): " << check(smallest) << "\n  zapisano w " << file_name << std::endl;
+        } else {
+            std::cerr << "Nie udało się otworzyć pliku do zapisu!" << std::endl;
+        }
+    }
+
+    std::cout << "Sprawdzono " << instance_count << " instancji, błędy: " << failed_seeds.size() << std::endl;
+    return failed_seeds.empty() ? 0 : 1;
+}